@@ -0,0 +1,148 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmarks.h"
+#include "Timer.h"
+
+#include "sergut/JsonSerializer.h"
+#include "sergut/Util.h"
+#include "sergut/XmlSerializer.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+std::atomic<std::size_t> allocationCount(0);
+}
+
+// Count all heap allocations of the benchmark executable
+void* operator new(std::size_t size)
+{
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  if(void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+namespace {
+
+struct Item {
+  std::string name;
+  long long id;
+  double price;
+};
+
+SERGUT_FUNCTION(Item, data, ar)
+{
+  ar
+      & SERGUT_MMEMBER(data, id)
+      & SERGUT_MMEMBER(data, price)
+      & sergut::children
+      & SERGUT_MMEMBER(data, name);
+}
+
+struct Response {
+  std::string status;
+  int code;
+  std::vector<Item> items;
+};
+
+SERGUT_FUNCTION(Response, data, ar)
+{
+  ar
+      & SERGUT_MMEMBER(data, code)
+      & sergut::children
+      & SERGUT_MMEMBER(data, status)
+      & SERGUT_NESTED_MMEMBER(data, items, item);
+}
+
+static const std::size_t messageCount = 100000;
+
+Response createResponse()
+{
+  Response response{"Everything is fine, the request has been processed completely", 200, {}};
+  for(long long i = 0; i < 20; ++i) {
+    response.items.push_back(Item{"Item with a name that is longer than the small string buffer", i, i * 1.25});
+  }
+  return response;
+}
+
+template<typename Serialize>
+void measure(const char* name, const Serialize& serialize)
+{
+  std::size_t size = 0;
+  // warm up, e.g. the key caches of the JsonSerializer
+  serialize(size);
+  const std::size_t allocationsBefore = allocationCount.load();
+  {
+    Timer t(name);
+    for(std::size_t i = 0; i < messageCount; ++i) {
+      serialize(size);
+    }
+  }
+  const std::size_t allocations = allocationCount.load() - allocationsBefore;
+  std::cout << "Size: " << size << " Allocations per message: "
+            << static_cast<double>(allocations) / messageCount << std::endl;
+}
+
+}
+
+void doAllocationBenchmark()
+{
+  const Response response = createResponse();
+  measure("JsonSerializer new per message", [&](std::size_t& size) {
+    sergut::JsonSerializer ser;
+    ser.serializeData(response);
+    size = ser.data().size();
+  });
+  sergut::JsonSerializer jsonSer;
+  measure("JsonSerializer reset per message", [&](std::size_t& size) {
+    jsonSer.reset();
+    jsonSer.serializeData(response);
+    size = jsonSer.data().size();
+  });
+  measure("XmlSerializer new per message", [&](std::size_t& size) {
+    sergut::XmlSerializer ser;
+    ser.serializeData("response", response);
+    size = ser.data().size();
+  });
+  sergut::XmlSerializer xmlSer;
+  measure("XmlSerializer reset per message", [&](std::size_t& size) {
+    xmlSer.reset();
+    xmlSer.serializeData("response", response);
+    size = xmlSer.data().size();
+  });
+}
@@ -0,0 +1,82 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmarks.h"
+#include "Timer.h"
+
+#include "sergut/JsonDeserializer.h"
+#include "sergut/JsonSerializer.h"
+#include "sergut/Util.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct ArrayElement {
+  int id;
+  std::string name;
+};
+
+SERGUT_FUNCTION(ArrayElement, data, ar)
+{
+  ar
+      & SERGUT_MMEMBER(data, id)
+      & SERGUT_MMEMBER(data, name);
+}
+
+struct ArrayHolder {
+  std::vector<ArrayElement> elements;
+  std::vector<int> numbers;
+};
+
+SERGUT_FUNCTION(ArrayHolder, data, ar)
+{
+  ar
+      & SERGUT_MMEMBER(data, elements)
+      & SERGUT_MMEMBER(data, numbers);
+}
+
+}
+
+void doArrayDeserializationBenchmark()
+{
+  for(std::size_t size = 25000; size <= 400000; size *= 2) {
+    ArrayHolder holder;
+    for(std::size_t i = 0; i < size; ++i) {
+      holder.elements.push_back(ArrayElement{ static_cast<int>(i), "element" });
+      holder.numbers.push_back(static_cast<int>(i));
+    }
+    sergut::JsonSerializer ser;
+    ser.serializeData(holder);
+    const std::string json = ser.str();
+
+    const std::string label = "JsonDeserializer (" + std::to_string(size) + " elements per array)";
+    for(int i = 0; i < 3; ++i) {
+      Timer t(label.c_str());
+      sergut::JsonDeserializer deser(json);
+      if(deser.deserializeData<ArrayHolder>().numbers.size() != size) {
+        std::cout << "Wrong number of elements" << std::endl;
+      }
+    }
+  }
+}
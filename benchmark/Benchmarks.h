@@ -0,0 +1,49 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+/// Deserializes JSON arrays of growing size, which should take linear time
+void doArrayDeserializationBenchmark();
+
+/// Counts the heap allocations per serialized message with new and with reused serializers
+void doAllocationBenchmark();
+
+/// Serializes strings with few and with many characters that need escaping
+void doEscapingBenchmark();
+
+/// Compares the rapidjson DOM based JsonDeserializer (copying and in place) with the JsonPullDeserializer on a nested corpus
+void doJsonDeserializationBenchmark();
+
+/// Deserializes newline delimited JSON sequentially and in parallel with an increasing number of threads
+void doNdJsonBenchmark();
+
+/// Compares the number formatting of the serializers with formatting via std::ostream
+void doNumberFormattingBenchmark();
+
+/// Serializes structs with many members, which is dominated by writing the keys
+void doMemberKeyBenchmark();
+
+/// Serializes a large collection in parallel with an increasing number of threads
+void doParallelBenchmark();
+
+/// Deserializes JSON objects with an increasing number of members
+void doWideObjectBenchmark();
@@ -0,0 +1,149 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmarks.h"
+#include "Timer.h"
+
+#include "sergut/JsonSerializer.h"
+#include "sergut/Util.h"
+#include "sergut/XmlSerializer.h"
+#include "sergut/misc/EscapeScanner.h"
+
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+struct Texts {
+  std::vector<std::string> texts;
+};
+
+SERGUT_FUNCTION(Texts, data, ar)
+{
+  ar & sergut::children & SERGUT_NESTED_MMEMBER(data, texts, text);
+}
+
+static const std::size_t textCount = 100000;
+static const std::size_t textSize = 200;
+
+Texts generateTexts(const double escapeRatio)
+{
+  static const char special[] = "\"\\\n<>&'";
+  std::mt19937 rng(5);
+  std::uniform_real_distribution<double> ratioDist(0, 1);
+  std::uniform_int_distribution<int> plainDist('a', 'z');
+  std::uniform_int_distribution<int> specialDist(0, sizeof(special) - 2);
+  Texts data;
+  data.texts.reserve(textCount);
+  for(std::size_t i = 0; i < textCount; ++i) {
+    std::string text;
+    text.reserve(textSize);
+    for(std::size_t j = 0; j < textSize; ++j) {
+      text.push_back(ratioDist(rng) < escapeRatio ? special[specialDist(rng)] : static_cast<char>(plainDist(rng)));
+    }
+    data.texts.push_back(std::move(text));
+  }
+  return data;
+}
+
+/// The former escaping implementation with a map lookup per byte
+std::size_t escapeWithMap(const Texts& data)
+{
+  static const std::map<char, std::string> entities{
+    {'"',  "&quot;"},
+    {'&',  "&amp;" },
+    {'\'', "&apos;"},
+    {'<',  "&lt;"  },
+    {'>',  "&gt;"  },
+  };
+  std::ostringstream out;
+  for(const std::string& text: data.texts) {
+    std::string::const_iterator regionStartIt = text.begin();
+    std::string::const_iterator regionEndIt = text.begin();
+    while(regionEndIt != text.end()) {
+      const auto entityIt = entities.find(*regionEndIt);
+      if(entityIt != entities.end()) {
+        out.write(&*regionStartIt, regionEndIt - regionStartIt);
+        out << entityIt->second;
+        regionStartIt = ++regionEndIt;
+      } else {
+        ++regionEndIt;
+      }
+    }
+    out.write(&*regionStartIt, regionEndIt - regionStartIt);
+  }
+  return out.str().size();
+}
+
+std::size_t countWithScanner(const Texts& data)
+{
+  std::size_t count = 0;
+  for(const std::string& text: data.texts) {
+    const char* const end = text.data() + text.size();
+    for(const char* p = sergut::misc::EscapeScanner::findXmlSpecial(text.data(), end); p != end;
+        p = sergut::misc::EscapeScanner::findXmlSpecial(p + 1, end)) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+void runEscapingBenchmark(const Texts& data)
+{
+  std::size_t size = 0;
+  for(int i = 0; i < 3; ++i) {
+    Timer t("Escaping XML with map lookup per byte");
+    size = escapeWithMap(data);
+  }
+  std::cout << "Size: " << size << std::endl;
+  for(int i = 0; i < 3; ++i) {
+    Timer t("Scanning XML special bytes with EscapeScanner");
+    size = countWithScanner(data);
+  }
+  std::cout << "Special bytes: " << size << std::endl;
+  for(int i = 0; i < 3; ++i) {
+    Timer t("XmlSerializer");
+    sergut::XmlSerializer ser;
+    ser.serializeData("texts", data);
+    size = ser.str().size();
+  }
+  std::cout << "XML Size: " << size << std::endl;
+  for(int i = 0; i < 3; ++i) {
+    Timer t("JsonSerializer");
+    sergut::JsonSerializer ser;
+    ser.serializeData(data);
+    size = ser.take().size();
+  }
+  std::cout << "JSON Size: " << size << std::endl;
+}
+
+}
+
+void doEscapingBenchmark()
+{
+  std::cout << "Strings with few escapes (1%)" << std::endl;
+  runEscapingBenchmark(generateTexts(0.01));
+  std::cout << "Strings with many escapes (25%)" << std::endl;
+  runEscapingBenchmark(generateTexts(0.25));
+}
@@ -0,0 +1,219 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmarks.h"
+#include "Timer.h"
+
+#include "sergut/JsonDeserializer.h"
+#include "sergut/JsonPullDeserializer.h"
+#include "sergut/JsonSerializer.h"
+#include "sergut/Util.h"
+#include "sergut/json/detail/StructuralIndex.h"
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct JsonLevel3 {
+  std::string string1;
+  std::string string2;
+  std::string string3;
+  long long number4;
+  double number5;
+};
+
+SERGUT_FUNCTION(JsonLevel3, data, ar)
+{
+  ar
+      & SERGUT_MMEMBER(data, string1)
+      & SERGUT_MMEMBER(data, string2)
+      & SERGUT_OMEMBER(data, string3)
+      & SERGUT_MMEMBER(data, number4)
+      & SERGUT_MMEMBER(data, number5);
+}
+
+struct JsonLevel2 {
+  std::string string1;
+  std::vector<JsonLevel3> valuesLevel3;
+  std::vector<int> numbers;
+};
+
+SERGUT_FUNCTION(JsonLevel2, data, ar)
+{
+  ar
+      & SERGUT_MMEMBER(data, string1)
+      & SERGUT_NESTED_MMEMBER(data, valuesLevel3, valueLevel3)
+      & SERGUT_OMEMBER(data, numbers);
+}
+
+struct JsonLevel1 {
+  std::string string1;
+  std::vector<JsonLevel2> valuesLevel2;
+  JsonLevel3 level3;
+};
+
+SERGUT_FUNCTION(JsonLevel1, data, ar)
+{
+  ar
+      & SERGUT_MMEMBER(data, string1)
+      & SERGUT_MMEMBER(data, valuesLevel2)
+      & SERGUT_MMEMBER(data, level3);
+}
+
+struct JsonLevel0 {
+  std::vector<JsonLevel1> valuesLevel1;
+};
+
+SERGUT_FUNCTION(JsonLevel0, data, ar)
+{
+  ar & SERGUT_MMEMBER(data, valuesLevel1);
+}
+
+/// Binds only the first member of each element, the rest of the corpus is skipped
+struct JsonSparse1 {
+  std::string string1;
+};
+
+SERGUT_FUNCTION(JsonSparse1, data, ar)
+{
+  ar & SERGUT_MMEMBER(data, string1);
+}
+
+struct JsonSparse0 {
+  std::vector<JsonSparse1> valuesLevel1;
+};
+
+SERGUT_FUNCTION(JsonSparse0, data, ar)
+{
+  ar & SERGUT_MMEMBER(data, valuesLevel1);
+}
+
+static const std::size_t repeat = 24;
+
+static const char alphabet[] = " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}\n\t\xc3\xa4";
+
+std::string generateRandomString(std::mt19937& rng)
+{
+  std::uniform_int_distribution<std::size_t> size(0, 40);
+  std::uniform_int_distribution<std::size_t> character(0, sizeof(alphabet) - 2);
+  std::string s(size(rng), ' ');
+  for(char& c: s) {
+    c = alphabet[character(rng)];
+  }
+  return s;
+}
+
+JsonLevel3 generateLevel3(std::mt19937& rng)
+{
+  std::uniform_int_distribution<long long> number(-1000000000, 1000000000);
+  // the fraction ensures that the DOM does not store the double as integer
+  return JsonLevel3{ generateRandomString(rng), generateRandomString(rng), generateRandomString(rng),
+                     number(rng), static_cast<double>(number(rng) * 10 + 5) / 10000 };
+}
+
+JsonLevel0 generateCorpus()
+{
+  std::mt19937 rng(23);
+  JsonLevel0 corpus;
+  for(std::size_t i = 0; i < repeat; ++i) {
+    JsonLevel1 level1{ generateRandomString(rng), {}, generateLevel3(rng) };
+    for(std::size_t j = 0; j < repeat; ++j) {
+      JsonLevel2 level2{ generateRandomString(rng), {}, {} };
+      for(std::size_t k = 0; k < repeat; ++k) {
+        level2.valuesLevel3.push_back(generateLevel3(rng));
+        level2.numbers.push_back(static_cast<int>(rng() % 100000));
+      }
+      level1.valuesLevel2.push_back(std::move(level2));
+    }
+    corpus.valuesLevel1.push_back(std::move(level1));
+  }
+  return corpus;
+}
+
+}
+
+void doJsonDeserializationBenchmark()
+{
+  sergut::JsonSerializer ser;
+  ser.serializeData(generateCorpus());
+  const std::string json = ser.str();
+  std::cout << "JSON String Size: " << json.size() << std::endl;
+
+  std::size_t elementCount = 0;
+  for(int i = 0; i < 20; ++i) {
+    Timer t("JsonDeserializer (rapidjson DOM)");
+    sergut::JsonDeserializer deser(json);
+    elementCount += deser.deserializeData<JsonLevel0>().valuesLevel1.size();
+  }
+  for(int i = 0; i < 20; ++i) {
+    std::vector<char> buffer(json.begin(), json.end());
+    Timer t("JsonDeserializer (rapidjson DOM, parsed in place)");
+    sergut::JsonDeserializer deser(std::move(buffer));
+    elementCount += deser.deserializeData<JsonLevel0>().valuesLevel1.size();
+  }
+  sergut::JsonDeserializer::ParseContext parseContext;
+  for(int i = 0; i < 20; ++i) {
+    Timer t("JsonDeserializer (rapidjson DOM, reused parse context)");
+    sergut::JsonDeserializer deser(json, parseContext);
+    elementCount += deser.deserializeData<JsonLevel0>().valuesLevel1.size();
+  }
+  for(int i = 0; i < 20; ++i) {
+    Timer t("JsonPullDeserializer");
+    sergut::JsonPullDeserializer deser(json);
+    elementCount += deser.deserializeData<JsonLevel0>().valuesLevel1.size();
+  }
+  for(int i = 0; i < 20; ++i) {
+    Timer t("JsonPullDeserializer (structural index)");
+    sergut::JsonPullDeserializer deser(sergut::json::PullParser::createIndexedParser(sergut::misc::ConstStringRef(json)));
+    elementCount += deser.deserializeData<JsonLevel0>().valuesLevel1.size();
+  }
+  for(int i = 0; i < 20; ++i) {
+    Timer t("JsonPullDeserializer (skipping most members)");
+    sergut::JsonPullDeserializer deser(json);
+    elementCount += deser.deserializeData<JsonSparse0>().valuesLevel1.size();
+  }
+  for(int i = 0; i < 20; ++i) {
+    Timer t("JsonPullDeserializer (skipping most members, structural index)");
+    sergut::JsonPullDeserializer deser(sergut::json::PullParser::createIndexedParser(sergut::misc::ConstStringRef(json)));
+    elementCount += deser.deserializeData<JsonSparse0>().valuesLevel1.size();
+  }
+  typedef sergut::json::detail::StructuralIndex StructuralIndex;
+  const std::pair<StructuralIndex::Implementation, const char*> implementations[] = {
+    { StructuralIndex::Implementation::Scalar, "StructuralIndex::build (scalar)" },
+    { StructuralIndex::Implementation::Sse2,   "StructuralIndex::build (SSE2)" },
+    { StructuralIndex::Implementation::Avx2,   "StructuralIndex::build (AVX2)" }
+  };
+  for(const auto& implementation: implementations) {
+    if(!StructuralIndex::isSupported(implementation.first)) {
+      continue;
+    }
+    StructuralIndex index;
+    for(int i = 0; i < 20; ++i) {
+      Timer t(implementation.second);
+      index.build(json.data(), json.size(), implementation.first);
+    }
+  }
+  std::cout << "Deserialized elements: " << elementCount << std::endl;
+}
@@ -0,0 +1,136 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmarks.h"
+#include "Timer.h"
+
+#include "sergut/JsonSerializer.h"
+#include "sergut/Util.h"
+
+#include <iostream>
+#include <vector>
+
+namespace {
+
+struct WideStruct {
+  int member01 = 0;
+  int member02 = 1;
+  int member03 = 2;
+  int member04 = 3;
+  int member05 = 4;
+  int member06 = 5;
+  int member07 = 6;
+  int member08 = 7;
+  int member09 = 8;
+  int member10 = 9;
+  int member11 = 10;
+  int member12 = 11;
+  int member13 = 12;
+  int member14 = 13;
+  int member15 = 14;
+  int member16 = 15;
+  int member17 = 16;
+  int member18 = 17;
+  int member19 = 18;
+  int member20 = 19;
+  int member21 = 20;
+  int member22 = 21;
+  int member23 = 22;
+  int member24 = 23;
+  int member25 = 24;
+  int member26 = 25;
+  int member27 = 26;
+  int member28 = 27;
+  int member29 = 28;
+  int member30 = 29;
+  int member31 = 30;
+  int member32 = 31;
+  int member33 = 32;
+  int member34 = 33;
+  int member35 = 34;
+  int member36 = 35;
+  int member37 = 36;
+  int member38 = 37;
+  int member39 = 38;
+  int member40 = 39;
+};
+
+SERGUT_FUNCTION(WideStruct, data, ar)
+{
+  ar
+      & SERGUT_MMEMBER(data, member01)
+      & SERGUT_MMEMBER(data, member02)
+      & SERGUT_MMEMBER(data, member03)
+      & SERGUT_MMEMBER(data, member04)
+      & SERGUT_MMEMBER(data, member05)
+      & SERGUT_MMEMBER(data, member06)
+      & SERGUT_MMEMBER(data, member07)
+      & SERGUT_MMEMBER(data, member08)
+      & SERGUT_MMEMBER(data, member09)
+      & SERGUT_MMEMBER(data, member10)
+      & SERGUT_MMEMBER(data, member11)
+      & SERGUT_MMEMBER(data, member12)
+      & SERGUT_MMEMBER(data, member13)
+      & SERGUT_MMEMBER(data, member14)
+      & SERGUT_MMEMBER(data, member15)
+      & SERGUT_MMEMBER(data, member16)
+      & SERGUT_MMEMBER(data, member17)
+      & SERGUT_MMEMBER(data, member18)
+      & SERGUT_MMEMBER(data, member19)
+      & SERGUT_MMEMBER(data, member20)
+      & SERGUT_MMEMBER(data, member21)
+      & SERGUT_MMEMBER(data, member22)
+      & SERGUT_MMEMBER(data, member23)
+      & SERGUT_MMEMBER(data, member24)
+      & SERGUT_MMEMBER(data, member25)
+      & SERGUT_MMEMBER(data, member26)
+      & SERGUT_MMEMBER(data, member27)
+      & SERGUT_MMEMBER(data, member28)
+      & SERGUT_MMEMBER(data, member29)
+      & SERGUT_MMEMBER(data, member30)
+      & SERGUT_MMEMBER(data, member31)
+      & SERGUT_MMEMBER(data, member32)
+      & SERGUT_MMEMBER(data, member33)
+      & SERGUT_MMEMBER(data, member34)
+      & SERGUT_MMEMBER(data, member35)
+      & SERGUT_MMEMBER(data, member36)
+      & SERGUT_MMEMBER(data, member37)
+      & SERGUT_MMEMBER(data, member38)
+      & SERGUT_MMEMBER(data, member39)
+      & SERGUT_MMEMBER(data, member40);
+}
+
+static const std::size_t structCount = 200000;
+
+}
+
+void doMemberKeyBenchmark()
+{
+  const std::vector<WideStruct> data(structCount);
+  std::size_t size = 0;
+  for(int i = 0; i < 5; ++i) {
+    Timer t("JsonSerializer (40 members per struct)");
+    sergut::JsonSerializer ser;
+    ser.serializeData(data);
+    size = ser.take().size();
+  }
+  std::cout << "JSON Size: " << size << std::endl;
+}
@@ -0,0 +1,112 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmarks.h"
+#include "Timer.h"
+
+#include "sergut/JsonSerializer.h"
+#include "sergut/NdJsonDeserializer.h"
+#include "sergut/Util.h"
+#include "sergut/misc/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct LogRecord {
+  long long timestamp = 0;
+  std::string host;
+  std::string message;
+  double duration = 0;
+  std::vector<int> codes;
+};
+
+SERGUT_FUNCTION(LogRecord, data, ar)
+{
+  ar
+      & SERGUT_MMEMBER(data, timestamp)
+      & SERGUT_MMEMBER(data, host)
+      & SERGUT_MMEMBER(data, message)
+      & SERGUT_MMEMBER(data, duration)
+      & SERGUT_MMEMBER(data, codes);
+}
+
+static const std::size_t recordCount = 300000;
+
+}
+
+void doNdJsonBenchmark()
+{
+  std::string ndjson;
+  for(std::size_t i = 0; i < recordCount; ++i) {
+    LogRecord record;
+    record.timestamp = 1500000000000LL + static_cast<long long>(i) * 17;
+    record.host = "host-" + std::to_string(i % 64);
+    record.message = "Request " + std::to_string(i) + " handled \"successfully\"";
+    record.duration = (static_cast<double>(i % 1000) * 10 + 5) / 10000;
+    record.codes.assign(i % 6, static_cast<int>(i % 600));
+    sergut::JsonSerializer ser;
+    ser.serializeData(record);
+    ndjson += ser.str();
+    ndjson += '\n';
+  }
+  std::cout << "NDJSON Size: " << ndjson.size() << std::endl;
+
+  std::size_t deserialized = 0;
+  for(int i = 0; i < 3; ++i) {
+    Timer t("NdJsonDeserializer (sequential)");
+    sergut::NdJsonDeserializer deser;
+    deser.appendData(sergut::misc::ConstStringRef(ndjson));
+    std::vector<LogRecord> records;
+    deserialized += deser.deserializeRecords<LogRecord>(records);
+  }
+
+  const std::size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+  for(std::size_t threads = 1; threads <= maxThreads; ++threads) {
+    std::cout << "Threads: " << threads << std::endl;
+    // the calling thread takes part in the work
+    sergut::misc::ThreadPool pool(threads - 1);
+    for(int i = 0; i < 3; ++i) {
+      Timer t("NdJsonDeserializer (input order)");
+      sergut::NdJsonDeserializer deser;
+      deser.setThreadPool(&pool, sergut::NdJsonDeserializer::RecordOrder::InputOrder);
+      deser.appendData(sergut::misc::ConstStringRef(ndjson));
+      std::vector<LogRecord> records;
+      deserialized += deser.deserializeRecords<LogRecord>(records);
+    }
+    for(int i = 0; i < 3; ++i) {
+      Timer t("NdJsonDeserializer (unordered)");
+      sergut::NdJsonDeserializer deser;
+      deser.setThreadPool(&pool, sergut::NdJsonDeserializer::RecordOrder::Unordered);
+      deser.appendData(sergut::misc::ConstStringRef(ndjson));
+      std::atomic<long long> timestampSum(0);
+      deserialized += deser.deserializeRecords<LogRecord>([&timestampSum](LogRecord&& record) {
+        timestampSum += record.timestamp;
+      });
+    }
+  }
+  std::cout << "Deserialized records: " << deserialized << std::endl;
+}
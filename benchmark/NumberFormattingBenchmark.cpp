@@ -0,0 +1,130 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmarks.h"
+#include "Timer.h"
+
+#include "sergut/JsonSerializer.h"
+#include "sergut/Util.h"
+#include "sergut/XmlSerializer.h"
+#include "sergut/misc/NumberFormatter.h"
+
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+struct Measurement {
+  long long id;
+  unsigned int count;
+  double value;
+  double deviation;
+  float ratio;
+};
+
+SERGUT_FUNCTION(Measurement, data, ar)
+{
+  ar
+      & SERGUT_MMEMBER(data, id)
+      & SERGUT_MMEMBER(data, count)
+      & SERGUT_MMEMBER(data, value)
+      & SERGUT_MMEMBER(data, deviation)
+      & SERGUT_MMEMBER(data, ratio);
+}
+
+struct Measurements {
+  std::vector<Measurement> measurements;
+};
+
+SERGUT_FUNCTION(Measurements, data, ar)
+{
+  ar & sergut::children & SERGUT_NESTED_MMEMBER(data, measurements, measurement);
+}
+
+static const std::size_t numberCount = 1000000;
+
+}
+
+void doNumberFormattingBenchmark()
+{
+  std::mt19937_64 rng(17);
+  std::uniform_real_distribution<double> doubleDist(-1e6, 1e6);
+  std::uniform_int_distribution<long long> intDist(-1000000000LL, 1000000000LL);
+
+  Measurements data;
+  data.measurements.reserve(numberCount);
+  for(std::size_t i = 0; i < numberCount; ++i) {
+    const double value = doubleDist(rng);
+    data.measurements.push_back(Measurement{intDist(rng), static_cast<unsigned int>(i), value,
+                                            value / 3, static_cast<float>(value / 7)});
+  }
+
+  std::size_t size = 0;
+  {
+    Timer t("Formatting numbers via std::ostream (6 significant digits)");
+    std::ostringstream out;
+    for(const Measurement& m: data.measurements) {
+      out << m.id << m.count << m.value << m.deviation << m.ratio;
+    }
+    size = out.str().size();
+  }
+  std::cout << "Size: " << size << std::endl;
+  {
+    Timer t("Formatting numbers via std::ostream (round trip precision)");
+    std::ostringstream out;
+    out.precision(17);
+    for(const Measurement& m: data.measurements) {
+      out << m.id << m.count << m.value << m.deviation << m.ratio;
+    }
+    size = out.str().size();
+  }
+  std::cout << "Size: " << size << std::endl;
+  {
+    Timer t("Formatting numbers via NumberFormatter");
+    std::string out;
+    char buf[sergut::misc::NumberFormatter::maxLength];
+    for(const Measurement& m: data.measurements) {
+      out.append(buf, sergut::misc::NumberFormatter::format(buf, m.id));
+      out.append(buf, sergut::misc::NumberFormatter::format(buf, m.count));
+      out.append(buf, sergut::misc::NumberFormatter::format(buf, m.value));
+      out.append(buf, sergut::misc::NumberFormatter::format(buf, m.deviation));
+      out.append(buf, sergut::misc::NumberFormatter::format(buf, m.ratio));
+    }
+    size = out.size();
+  }
+  std::cout << "Size: " << size << std::endl;
+  for(int i = 0; i < 5; ++i) {
+    Timer t("JsonSerializer");
+    sergut::JsonSerializer ser;
+    ser.serializeData(data);
+    size = ser.take().size();
+  }
+  std::cout << "JSON Size: " << size << std::endl;
+  for(int i = 0; i < 5; ++i) {
+    Timer t("XmlSerializer");
+    sergut::XmlSerializer ser;
+    ser.serializeData("measurements", data);
+    size = ser.str().size();
+  }
+  std::cout << "XML Size: " << size << std::endl;
+}
@@ -0,0 +1,100 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmarks.h"
+#include "Timer.h"
+
+#include "sergut/JsonSerializer.h"
+#include "sergut/Util.h"
+#include "sergut/XmlSerializer.h"
+#include "sergut/misc/ThreadPool.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Record {
+  long long id;
+  std::string name;
+  double value;
+  std::vector<int> tags;
+};
+
+SERGUT_FUNCTION(Record, data, ar)
+{
+  ar
+      & SERGUT_MMEMBER(data, id)
+      & SERGUT_MMEMBER(data, value)
+      & sergut::children
+      & SERGUT_MMEMBER(data, name)
+      & SERGUT_MMEMBER(data, tags);
+}
+
+struct Export {
+  std::vector<Record> records;
+};
+
+SERGUT_FUNCTION(Export, data, ar)
+{
+  ar & sergut::children & SERGUT_NESTED_MMEMBER(data, records, record);
+}
+
+static const std::size_t recordCount = 500000;
+
+}
+
+void doParallelBenchmark()
+{
+  Export data;
+  data.records.reserve(recordCount);
+  for(std::size_t i = 0; i < recordCount; ++i) {
+    data.records.push_back(Record{static_cast<long long>(i), "Record \"" + std::to_string(i) + "\" <exported>",
+                                  i / 7.0, std::vector<int>(i % 8, static_cast<int>(i))});
+  }
+
+  const std::size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+  for(std::size_t threads = 1; threads <= maxThreads; ++threads) {
+    std::cout << "Threads: " << threads << std::endl;
+    // the calling thread takes part in the work
+    sergut::misc::ThreadPool pool(threads - 1);
+    std::size_t size = 0;
+    for(int i = 0; i < 3; ++i) {
+      Timer t("JsonSerializer");
+      sergut::JsonSerializer ser;
+      ser.setThreadPool(&pool, 4096);
+      ser.serializeData(data);
+      size = ser.data().size();
+    }
+    std::cout << "JSON Size: " << size << std::endl;
+    for(int i = 0; i < 3; ++i) {
+      Timer t("XmlSerializer");
+      sergut::XmlSerializer ser;
+      ser.setThreadPool(&pool, 4096);
+      ser.serializeData("export", data);
+      size = ser.data().size();
+    }
+    std::cout << "XML Size: " << size << std::endl;
+  }
+}
@@ -0,0 +1,99 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmarks.h"
+#include "Timer.h"
+
+#include "sergut/JsonDeserializer.h"
+#include "sergut/JsonSerializer.h"
+#include "sergut/Util.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const std::vector<std::string>& memberNames()
+{
+  static const std::vector<std::string> names = [] {
+    std::vector<std::string> n;
+    for(int i = 0; i < 256; ++i) {
+      n.push_back("someMemberName" + std::to_string(i));
+    }
+    return n;
+  }();
+  return names;
+}
+
+/// A struct with \c N int members that are named by their position
+template<std::size_t N>
+struct WideObject {
+  int values[N];
+};
+
+template<std::size_t N>
+inline const char* getTypeName(const WideObject<N>*) { return "WideObject"; }
+
+template<typename DT, typename Archive, std::size_t N>
+void serialize(Archive& ar, DT& data, const WideObject<N>*)
+{
+  for(std::size_t i = 0; i < N; ++i) {
+    ar & Archive::toNamedMember(memberNames()[i].c_str(), data.values[i], true);
+  }
+}
+
+/// Deserializes the same number of members, distributed over objects with \c N members each
+template<std::size_t N>
+void benchmarkWideObjects(const std::size_t totalMemberCount)
+{
+  std::vector<WideObject<N>> objects(totalMemberCount / N);
+  for(WideObject<N>& object: objects) {
+    for(std::size_t i = 0; i < N; ++i) {
+      object.values[i] = static_cast<int>(i);
+    }
+  }
+  sergut::JsonSerializer ser;
+  ser.serializeData(objects);
+  const std::string json = ser.str();
+
+  const std::string label = "JsonDeserializer (" + std::to_string(N) + " members per object)";
+  for(int i = 0; i < 5; ++i) {
+    Timer t(label.c_str());
+    sergut::JsonDeserializer deser(json);
+    if(deser.deserializeData<std::vector<WideObject<N>>>().size() != objects.size()) {
+      std::cout << "Wrong number of objects" << std::endl;
+    }
+  }
+}
+
+}
+
+void doWideObjectBenchmark()
+{
+  const std::size_t totalMemberCount = 256 * 4096;
+  benchmarkWideObjects<8>(totalMemberCount);
+  benchmarkWideObjects<16>(totalMemberCount);
+  benchmarkWideObjects<32>(totalMemberCount);
+  benchmarkWideObjects<64>(totalMemberCount);
+  benchmarkWideObjects<128>(totalMemberCount);
+  benchmarkWideObjects<256>(totalMemberCount);
+}
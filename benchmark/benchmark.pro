@@ -10,6 +10,7 @@ TARGET = benchmark
 CONFIG += console
 CONFIG -= app_bundle
 CONFIG += c++11
+CONFIG += thread
 
 LIBS += -L "$${OUT_PWD}/../lib" -L "$${CPP_TINYXML_LIB_PATH}" -lsergut -ltinyxml2 -ltinyxml
 
@@ -18,7 +19,18 @@ QMAKE_CXXFLAGS += -ggdb3
 INCLUDEPATH = ../lib "$${CPP_TINYXML_INCLUDE_PATH}"
 
 SOURCES += \
+    AllocationBenchmark.cpp \
+    ArrayDeserializationBenchmark.cpp \
+    EscapingBenchmark.cpp \
+    JsonDeserializationBenchmark.cpp \
+    MemberKeyBenchmark.cpp \
+    NdJsonBenchmark.cpp \
+    NumberFormattingBenchmark.cpp \
+    ParallelBenchmark.cpp \
+    WideObjectBenchmark.cpp \
     main.cpp
 
-HEADERS +=
+HEADERS += \
+    Benchmarks.h \
+    Timer.h
 
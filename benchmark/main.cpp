@@ -1,12 +1,16 @@
+#include "Benchmarks.h"
+#include "Timer.h"
+
 #include "sergut/Util.h"
 #include "sergut/XmlDeserializer.h"
 #include "sergut/XmlDeserializerTiny.h"
 #include "sergut/XmlDeserializerTiny2.h"
+#include "sergut/xml/PullParser.h"
 
-#include <chrono>
 #include <iostream>
 #include <sstream>
 #include <map>
+#include <memory>
 #include <vector>
 #include <random>
 
@@ -173,19 +177,6 @@ std::string generateLevel0(RNG& rng)
 }
 
 
-struct Timer {
-  Timer(const char* name) : _name(name), startTime(std::chrono::high_resolution_clock::now()) { }
-  ~Timer() {
-    const std::chrono::milliseconds us = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startTime);
-    std::cout << _name
-              << ": Elapsed: "
-              << us.count()
-              << "us"
-              << std::endl; }
-  const char* _name;
-  std::chrono::high_resolution_clock::time_point startTime;
-};
-
 void doBenchmark()
 {
   RNG generator(23);
@@ -194,6 +185,13 @@ void doBenchmark()
 
   std::cout << "XML String Size: " << data.size() << std::endl;
 
+  for(int i = 0; i < 5; ++i) {
+    Timer t("xml::PullParser (20 passes)");
+    for(int pass = 0; pass < 20; ++pass) {
+      std::unique_ptr<sergut::xml::PullParser> parser = sergut::xml::PullParser::createParser(sergut::misc::ConstStringRef(data));
+      while(parser->parseNext() != sergut::xml::ParseTokenType::CloseDocument && parser->isOk()) { }
+    }
+  }
   for(int i = 0; i < 20; ++i) {
     {
       Timer t("XmlDeserializer");
@@ -257,9 +255,31 @@ void doTestRapidJson()
                   "\"intVectorMember11\":[1,2,3,4],\"childMember12\":{\"grandChildValue\":-99}}");
 }
 
-int main()
+int main(int argc, char* argv[])
 {
-  doTestRapidJson();
-  //  doBenchmark();
+  const std::string benchmark = argc > 1 ? argv[1] : "";
+  if(benchmark == "allocations") {
+    doAllocationBenchmark();
+  } else if(benchmark == "arrays") {
+    doArrayDeserializationBenchmark();
+  } else if(benchmark == "escaping") {
+    doEscapingBenchmark();
+  } else if(benchmark == "json") {
+    doJsonDeserializationBenchmark();
+  } else if(benchmark == "keys") {
+    doMemberKeyBenchmark();
+  } else if(benchmark == "ndjson") {
+    doNdJsonBenchmark();
+  } else if(benchmark == "numbers") {
+    doNumberFormattingBenchmark();
+  } else if(benchmark == "parallel") {
+    doParallelBenchmark();
+  } else if(benchmark == "wide") {
+    doWideObjectBenchmark();
+  } else if(benchmark == "xml") {
+    doBenchmark();
+  } else {
+    doTestRapidJson();
+  }
   return 0;
 }
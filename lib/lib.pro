@@ -14,6 +14,8 @@ TARGET =  sergut
 CONFIG += console
 CONFIG -= app_bundle
 CONFIG += c++11
+CONFIG += thread
+CONFIG += object_parallel_to_source
 CONFIG += staticlib
 
 INCLUDEPATH += "$${CPP_TINYXML_INCLUDE_PATH}" "$${CPP_RAPIDJSON_PATH}"
@@ -22,7 +24,9 @@ QMAKE_CXXFLAGS += -ggdb3
 
 SOURCES += \
     VersionTracker.cpp \
+    sergut/JsonPullDeserializer.cpp \
     sergut/JsonSerializer.cpp \
+    sergut/NdJsonDeserializer.cpp \
     sergut/ParsingException.cpp \
     sergut/UrlDeserializer.cpp \
     sergut/UrlSerializeToVector.cpp \
@@ -30,25 +34,38 @@ SOURCES += \
     sergut/Version.cpp \
     sergut/XmlDeserializer.cpp \
     sergut/XmlSerializer.cpp \
+    sergut/XmlSnippetDeserializer.cpp \
     sergut/XsdGenerator.cpp \
     sergut/detail/JavaClassGeneratorBase.cpp \
     sergut/detail/Member.cpp \
     sergut/detail/MemberDeserializer.cpp \
     sergut/detail/NameSpace.cpp \
     sergut/detail/TypeName.cpp \
+    sergut/json/PullParser.cpp \
+    sergut/json/detail/PullParserUtf8.cpp \
+    sergut/json/detail/StructuralIndex.cpp \
     sergut/marshaller/RequestClient.cpp \
     sergut/misc/Debug.cpp \
+    sergut/misc/EscapeScanner.cpp \
+    sergut/misc/MappedFile.cpp \
+    sergut/misc/NumberFormatter.cpp \
+    sergut/misc/OutputSink.cpp \
     sergut/misc/ReadHelper.cpp \
+    sergut/misc/ThreadPool.cpp \
     sergut/unicode/Utf8Codec.cpp \
     sergut/xml/PullParser.cpp \
+    sergut/xml/detail/Helper.cpp \
+    sergut/xml/detail/RecordedPullParser.cpp \
 
 HEADERS += \
     VersionTracker.h \
     sergut/DeserializerBase.h \
     sergut/Exception.h \
     sergut/JavaClassGenerator.h \
+    sergut/JsonPullDeserializer.h \
     sergut/JsonSerializer.h \
     sergut/Misc.h \
+    sergut/NdJsonDeserializer.h \
     sergut/ParsingException.h \
     sergut/SerializationException.h \
     sergut/SerializerBase.h \
@@ -60,11 +77,14 @@ HEADERS += \
     sergut/Version.h \
     sergut/XmlDeserializer.h \
     sergut/XmlSerializer.h \
+    sergut/XmlSnippetDeserializer.h \
     sergut/XmlValueType.h \
     sergut/XsdGenerator.h \
     sergut/detail/DummySerializer.h \
     sergut/detail/JavaClassGeneratorBase.h \
     sergut/detail/JavaClassGeneratorBuilder.h \
+    sergut/detail/JsonKeyCache.h \
+    sergut/detail/JsonMemberNameIndex.h \
     sergut/detail/Member.h \
     sergut/detail/MemberDeserializer.h \
     sergut/detail/NameSpace.h \
@@ -72,6 +92,10 @@ HEADERS += \
     sergut/detail/TypeName.h \
     sergut/detail/XmlDeserializerDomBase.h \
     sergut/detail/XmlDeserializerHelper.h \
+    sergut/json/ParseTokenType.h \
+    sergut/json/PullParser.h \
+    sergut/json/detail/PullParserUtf8.h \
+    sergut/json/detail/StructuralIndex.h \
     sergut/marshaller/InvalidCodePathException.h \
     sergut/marshaller/MarshallingException.h \
     sergut/marshaller/RemoteCallingException.h \
@@ -83,8 +107,14 @@ HEADERS += \
     sergut/marshaller/detail/FunctionSignatureExtractor.h \
     sergut/misc/ConstStringRef.h \
     sergut/misc/DataType.h \
+    sergut/misc/EscapeScanner.h \
+    sergut/misc/InputSource.h \
+    sergut/misc/MappedFile.h \
+    sergut/misc/NumberFormatter.h \
+    sergut/misc/OutputSink.h \
     sergut/misc/ReadHelper.h \
     sergut/misc/StringRef.h \
+    sergut/misc/ThreadPool.h \
     sergut/unicode/ParseResult.h \
     sergut/unicode/Utf16Codec.h \
     sergut/unicode/Utf32Char.h \
@@ -99,6 +129,7 @@ HEADERS += \
     sergut/xml/detail/PullParserUtf8.h \
     sergut/xml/detail/ReaderState.h \
     sergut/xml/detail/ReaderStateResetter.h \
+    sergut/xml/detail/RecordedPullParser.h \
     sergut/xml/detail/TextDecodingHelper.h \
 
 withTinyXml {
@@ -128,5 +159,6 @@ SOURCES += \
 
 HEADERS += \
     sergut/JsonDeserializer.h \
+    sergut/detail/JsonMemberIndex.h \
 
 }
@@ -23,10 +23,111 @@
 
 #include "sergut/ParsingException.h"
 
+#include <algorithm>
+
+sergut::JsonDeserializer::ParseContext::ParseContext(const std::size_t initialCapacity)
+  : _valueBuffer(initialCapacity)
+  , _stackBuffer(std::max(initialCapacity / 16, std::size_t(1024)))
+{
+  resetAllocator(_valueAllocator, _valueBuffer);
+  resetAllocator(_stackAllocator, _stackBuffer);
+}
+
+sergut::JsonDeserializer::ParseContext& sergut::JsonDeserializer::ParseContext::forCurrentThread()
+{
+  static thread_local ParseContext parseContext;
+  return parseContext;
+}
+
+bool sergut::JsonDeserializer::ParseContext::acquire()
+{
+  if(_inUse) {
+    return false;
+  }
+  _inUse = true;
+  return true;
+}
+
+void sergut::JsonDeserializer::ParseContext::release()
+{
+  resetAllocator(_valueAllocator, _valueBuffer);
+  resetAllocator(_stackAllocator, _stackBuffer);
+  _inUse = false;
+}
+
+void sergut::JsonDeserializer::ParseContext::resetAllocator(std::unique_ptr<Allocator>& allocator, std::vector<char>& buffer)
+{
+  if(allocator && allocator->Capacity() <= buffer.size()) {
+    // everything fitted into the buffer, so we just start over
+    allocator->Clear();
+    return;
+  }
+  if(allocator) {
+    // leave some headroom for the bookkeeping of the pool and for larger documents
+    const std::size_t usedSize = allocator->Size();
+    allocator.reset();
+    buffer.resize(usedSize + usedSize / 2);
+  }
+  allocator.reset(new Allocator(buffer.data(), buffer.size()));
+}
+
 sergut::JsonDeserializer::JsonDeserializer(const std::string& json)
-  : _jsonDocument(new rapidjson::Document)
-  , _currentElement(_jsonDocument.get())
 {
+  createDocument(nullptr);
   _jsonDocument->Parse(json.c_str());
 }
 
+sergut::JsonDeserializer::JsonDeserializer(const std::string& json, ParseContext& parseContext)
+{
+  createDocument(&parseContext);
+  _jsonDocument->Parse(json.c_str());
+}
+
+sergut::JsonDeserializer::JsonDeserializer(std::vector<char>&& json)
+  : _jsonBuffer(std::move(json))
+{
+  createDocument(nullptr);
+  parseInPlace();
+}
+
+sergut::JsonDeserializer::JsonDeserializer(std::vector<char>&& json, ParseContext& parseContext)
+  : _jsonBuffer(std::move(json))
+{
+  createDocument(&parseContext);
+  parseInPlace();
+}
+
+sergut::JsonDeserializer::~JsonDeserializer()
+{
+  releaseDocument();
+}
+
+void sergut::JsonDeserializer::createDocument(ParseContext* parseContext)
+{
+  if(parseContext != nullptr && parseContext->acquire()) {
+    _parseContext = parseContext;
+    _jsonDocument.reset(new Document(_parseContext->_valueAllocator.get(), 1024, _parseContext->_stackAllocator.get()));
+  } else {
+    _jsonDocument.reset(new Document);
+  }
+  _currentElement = _jsonDocument.get();
+}
+
+void sergut::JsonDeserializer::parseInPlace()
+{
+  // ParseInsitu() expects a null terminated string
+  if(_jsonBuffer.empty() || _jsonBuffer.back() != '\0') {
+    _jsonBuffer.push_back('\0');
+  }
+  _jsonDocument->ParseInsitu(_jsonBuffer.data());
+}
+
+void sergut::JsonDeserializer::releaseDocument()
+{
+  _currentElement = nullptr;
+  _jsonDocument.reset();
+  if(_parseContext != nullptr) {
+    _parseContext->release();
+    _parseContext = nullptr;
+  }
+}
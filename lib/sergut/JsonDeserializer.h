@@ -26,6 +26,7 @@
 #include "sergut/SerializationException.h"
 #include "sergut/Util.h"
 #include "sergut/detail/DummySerializer.h"
+#include "sergut/detail/JsonMemberIndex.h"
 #include "sergut/misc/ReadHelper.h"
 
 #define RAPIDJSON_ASSERT(x) \
@@ -56,9 +57,79 @@ class JsonDeserializer : public DeserializerBase
 public:
   class ErrorContext;
 
+  /**
+   * \brief Memory that is reused by consecutive \c JsonDeserializer instances
+   *
+   * Without a \c ParseContext each \c JsonDeserializer allocates the memory
+   * pools of its DOM and of the parse stack anew and frees them again, when
+   * the data is deserialized. A \c ParseContext keeps this memory, so that
+   * back-to-back deserializations reuse it instead. The buffers grow to the
+   * largest document that has been deserialized with the context.
+   *
+   * A \c ParseContext can only be used by one \c JsonDeserializer at a time,
+   * from the construction of the deserializer until \c deserializeData()
+   * returns or the deserializer is destroyed. A deserializer that is created
+   * while the context is in use falls back to allocating its own memory.
+   */
+  class ParseContext
+  {
+  public:
+    /// \param initialCapacity The initial size of the buffer for the DOM.
+    explicit ParseContext(const std::size_t initialCapacity = 64 * 1024);
+    ParseContext(const ParseContext&) = delete;
+    ParseContext& operator=(const ParseContext&) = delete;
+
+    /// \brief Get the \c ParseContext of the current thread
+    static ParseContext& forCurrentThread();
+
+  private:
+    friend class JsonDeserializer;
+    typedef rapidjson::MemoryPoolAllocator<> Allocator;
+
+    /// Marks the context as used and returns false, if it is already in use
+    bool acquire();
+    /// Resets the allocators, growing their buffers to the sizes used last time
+    void release();
+    static void resetAllocator(std::unique_ptr<Allocator>& allocator, std::vector<char>& buffer);
+
+  private:
+    std::vector<char> _valueBuffer;
+    std::vector<char> _stackBuffer;
+    std::unique_ptr<Allocator> _valueAllocator;
+    std::unique_ptr<Allocator> _stackAllocator;
+    bool _inUse = false;
+  };
+
 public:
   JsonDeserializer(const std::string& json);
 
+  /**
+   * \brief Create a JsonDeserializer that takes its memory out of \c parseContext
+   * \param json A string with the JSON data.
+   * \param parseContext The memory to use for the DOM and the parse stack.
+   */
+  JsonDeserializer(const std::string& json, ParseContext& parseContext);
+
+  /**
+   * \brief Create a JsonDeserializer moving the \c json into an inner variable.
+   *
+   * The JSON is parsed in place (rapidjson's in-situ parsing): the strings of
+   * the document are decoded inside of \c json and referenced by the document
+   * instead of being copied into its allocator.
+   * \param json A std::vector with the JSON data that will be moved into the class.
+   */
+  JsonDeserializer(std::vector<char>&& json);
+
+  /**
+   * \brief Create a JsonDeserializer that parses \c json in place and takes
+   *        its memory out of \c parseContext
+   * \param json A std::vector with the JSON data that will be moved into the class.
+   * \param parseContext The memory to use for the DOM and the parse stack.
+   */
+  JsonDeserializer(std::vector<char>&& json, ParseContext& parseContext);
+
+  ~JsonDeserializer();
+
   /**
    * \brief Deserialize data into type \c DT
    * \tparam DT The type into which the JSON should be deserialized.
@@ -72,12 +143,10 @@ public:
     try {
       deserializeValue(data);
     } catch(...) {
-      _currentElement = nullptr;
-      _jsonDocument.reset();
+      releaseDocument();
       throw;
     }
-    _currentElement = nullptr;
-    _jsonDocument.reset();
+    releaseDocument();
 
     return data;
   }
@@ -109,17 +178,16 @@ public:
   template<typename DT>
   JsonDeserializer& operator&(const NamedMemberForDeserialization<DT>& data) {
     auto currentElement = _currentElement;
-    auto memberIt = currentElement->FindMember(data.name);
-    if(memberIt == currentElement->MemberEnd() || memberIt->value.IsNull()) {
+    MemberIndex::Member* member = findMember(data.name);
+    if(member == nullptr || member->value.IsNull()) {
       if(data.mandatory) {
         throw ParsingException("Missing mandatory member");
       }
       return *this;
     }
-    _currentElement = &memberIt->value;
+    _currentElement = &member->value;
     deserializeValue(data.data);
     _currentElement = currentElement;
-    _currentElement->RemoveMember(memberIt);
     return *this;
   }
 
@@ -130,6 +198,16 @@ public:
   JsonDeserializer& operator&(const PlainChildFollows&) { return *this; }
 
 private:
+  typedef detail::JsonMemberIndex<rapidjson::Value> MemberIndex;
+
+  MemberIndex::Member* findMember(const char* name) {
+    if(_currentMemberIndex != nullptr) {
+      return _currentMemberIndex->find(name);
+    }
+    const auto memberIt = _currentElement->FindMember(name);
+    return memberIt == _currentElement->MemberEnd() ? nullptr : &*memberIt;
+  }
+
   uint64_t getMatchingNumericType(const unsigned long long&) const {
     if(!_currentElement->IsUint64()) {
       throw new ParsingException("Expecting unsigned numeric type, but got something else");
@@ -190,7 +268,7 @@ private:
     if(!_currentElement->IsString()) {
       throw ParsingException("Expected String");
     }
-    data = (*_currentElement).GetString();
+    data.assign(_currentElement->GetString(), _currentElement->GetStringLength());
   }
 
   void deserializeValue(char& data) {
@@ -221,13 +299,15 @@ private:
     if(!_currentElement->IsArray()) {
       throw ParsingException("Expecting Collection, but got something else");
     }
+    // the elements are visited by index and left in place, erasing them from
+    // the front of the array would take quadratic time
     const auto currentElement = _currentElement;
-    while(!currentElement->Empty()) {
-      _currentElement = currentElement->Begin();
+    const rapidjson::SizeType size = currentElement->Size();
+    for(rapidjson::SizeType i = 0; i < size; ++i) {
+      _currentElement = &(*currentElement)[i];
       typename Collection::value_type el;
       deserializeValue(el);
       insertIntoCollection(data, std::move(el));
-      currentElement->Erase(currentElement->Begin());
     }
     _currentElement = currentElement;
   }
@@ -263,13 +343,46 @@ private:
   -> decltype(serialize(DummyDeserializer::dummyInstance(), data, static_cast<typename std::decay<DT>::type*>(nullptr)),void())
   {
     auto* el = _currentElement;
+    // wide objects get a hash index for the member lookup, the indexes of
+    // finished objects are reused for the following ones
+    const MemberIndex* const outerMemberIndex = _currentMemberIndex;
+    _currentMemberIndex = nullptr;
+    if(el->IsObject() && el->MemberCount() > MemberIndex::minMemberCount) {
+      if(_usedMemberIndexes == _memberIndexes.size()) {
+        _memberIndexes.emplace_back(new MemberIndex);
+      }
+      MemberIndex& memberIndex = *_memberIndexes[_usedMemberIndexes++];
+      memberIndex.build(*el);
+      _currentMemberIndex = &memberIndex;
+    }
     serialize(*this, data, static_cast<typename std::decay<DT>::type*>(nullptr));
+    if(_currentMemberIndex != nullptr) {
+      --_usedMemberIndexes;
+    }
+    _currentMemberIndex = outerMemberIndex;
     _currentElement = el;
   }
 
+  /// Creates the document, taking its memory out of the parse context, if possible
+  void createDocument(ParseContext* parseContext);
+  void parseInPlace();
+  void releaseDocument();
+
 private:
-  std::unique_ptr<typename rapidjson::Document> _jsonDocument;
+  /// The parse stack is allocated out of a memory pool too, so that a
+  /// \c ParseContext can provide it
+  typedef rapidjson::GenericDocument<rapidjson::UTF8<>, ParseContext::Allocator, ParseContext::Allocator> Document;
+
+  /// The buffer the document has been parsed into, if parsed in place
+  std::vector<char> _jsonBuffer;
+  /// The context the document takes its memory from, if any
+  ParseContext* _parseContext = nullptr;
+  std::unique_ptr<Document> _jsonDocument;
   typename rapidjson::Value* _currentElement;
+  /// The member index of the current object, if it is wide enough to have one
+  const MemberIndex* _currentMemberIndex = nullptr;
+  std::vector<std::unique_ptr<MemberIndex>> _memberIndexes;
+  std::size_t _usedMemberIndexes = 0;
 };
 
 } // namespace sergut
@@ -0,0 +1,229 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "sergut/JsonPullDeserializer.h"
+
+#include <locale>
+#include <sstream>
+
+namespace sergut {
+
+static bool isDigit(const char c)
+{
+  return '0' <= c && c <= '9';
+}
+
+static void checkIsNumber(const json::PullParser& state)
+{
+  if(state.getCurrentTokenType() != json::ParseTokenType::Number) {
+    throw ParsingException("Expecting numeric type, but got something else");
+  }
+}
+
+static unsigned long long readIntegerMagnitude(const char* pos, const char* end)
+{
+  unsigned long long value = 0;
+  for(; pos != end; ++pos) {
+    if(!isDigit(*pos)) {
+      throw ParsingException("Expecting integral number, but got something else");
+    }
+    const unsigned digit = static_cast<unsigned>(*pos - '0');
+    if(value > (std::numeric_limits<unsigned long long>::max() - digit) / 10) {
+      throw ParsingException("Number is not within the value range of datatype");
+    }
+    value = value * 10 + digit;
+  }
+  return value;
+}
+
+JsonPullDeserializer::JsonPullDeserializer(const misc::ConstStringRef& json)
+  : jsonDocument(json::PullParser::createParser(json))
+{ }
+
+JsonPullDeserializer::JsonPullDeserializer(std::vector<char>&& json)
+  : jsonDocument(json::PullParser::createParser(std::move(json)))
+{ }
+
+JsonPullDeserializer::JsonPullDeserializer(std::unique_ptr<json::PullParser>&& parser)
+  : jsonDocument(std::move(parser))
+{ }
+
+void JsonPullDeserializer::checkToken(const json::PullParser& state)
+{
+  if(state.getCurrentTokenType() == json::ParseTokenType::IncompleteDocument) {
+    throw ParsingException("Incomplete JSON document");
+  }
+  if(state.getCurrentTokenType() == json::ParseTokenType::Error) {
+    throw ParsingException("Invalid JSON document");
+  }
+}
+
+json::ParseTokenType JsonPullDeserializer::nextToken(json::PullParser& state)
+{
+  state.parseNext();
+  checkToken(state);
+  return state.getCurrentTokenType();
+}
+
+void JsonPullDeserializer::skipValue(json::PullParser& state)
+{
+  state.skipValue();
+  checkToken(state);
+}
+
+long long JsonPullDeserializer::readSignedNumber(const json::PullParser& state)
+{
+  checkIsNumber(state);
+  const misc::ConstStringRef value = state.getCurrentValue();
+  const bool negative = value[0] == '-';
+  const unsigned long long magnitude = readIntegerMagnitude(value.begin() + (negative ? 1 : 0), value.end());
+  const unsigned long long maxMagnitude = static_cast<unsigned long long>(std::numeric_limits<long long>::max());
+  if(!negative) {
+    if(magnitude > maxMagnitude) {
+      throw ParsingException("Number is not within the value range of datatype");
+    }
+    return static_cast<long long>(magnitude);
+  }
+  if(magnitude > maxMagnitude + 1) {
+    throw ParsingException("Number is not within the value range of datatype");
+  }
+  return magnitude == maxMagnitude + 1 ? std::numeric_limits<long long>::min() : -static_cast<long long>(magnitude);
+}
+
+unsigned long long JsonPullDeserializer::readUnsignedNumber(const json::PullParser& state)
+{
+  checkIsNumber(state);
+  const misc::ConstStringRef value = state.getCurrentValue();
+  if(value[0] == '-') {
+    throw ParsingException("Expecting unsigned numeric type, but got something else");
+  }
+  return readIntegerMagnitude(value.begin(), value.end());
+}
+
+double JsonPullDeserializer::readDouble(const json::PullParser& state)
+{
+  checkIsNumber(state);
+  // The parser has already checked the number syntax. Numbers with at most 15
+  // significant digits and a small exponent are converted exactly, as both the
+  // mantissa and the power of 10 can be represented as double (Clinger's fast
+  // path). All others are converted by the standard library.
+  static const double exactPowersOf10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+  const misc::ConstStringRef value = state.getCurrentValue();
+  const char* pos = value.begin();
+  const bool negative = *pos == '-';
+  if(negative) {
+    ++pos;
+  }
+  uint64_t mantissa = 0;
+  int significantDigits = 0;
+  int exponent = 0;
+  for(; pos != value.end() && isDigit(*pos); ++pos) {
+    mantissa = mantissa * 10 + static_cast<unsigned>(*pos - '0');
+    if(mantissa != 0) {
+      ++significantDigits;
+    }
+    if(significantDigits > 15) {
+      break;
+    }
+  }
+  if(pos != value.end() && *pos == '.') {
+    for(++pos; pos != value.end() && isDigit(*pos) && significantDigits <= 15; ++pos) {
+      mantissa = mantissa * 10 + static_cast<unsigned>(*pos - '0');
+      if(mantissa != 0) {
+        ++significantDigits;
+      }
+      --exponent;
+    }
+  }
+  if(pos != value.end() && (*pos == 'e' || *pos == 'E')) {
+    ++pos;
+    const bool negativeExponent = *pos == '-';
+    if(*pos == '-' || *pos == '+') {
+      ++pos;
+    }
+    int explicitExponent = 0;
+    for(; pos != value.end() && explicitExponent < 10000; ++pos) {
+      explicitExponent = explicitExponent * 10 + (*pos - '0');
+    }
+    exponent += negativeExponent ? -explicitExponent : explicitExponent;
+  }
+  if(pos == value.end() && significantDigits <= 15 && -22 <= exponent && exponent <= 22) {
+    double result = static_cast<double>(mantissa);
+    if(exponent < 0) {
+      result /= exactPowersOf10[-exponent];
+    } else {
+      result *= exactPowersOf10[exponent];
+    }
+    return negative ? -result : result;
+  }
+
+  std::istringstream in(value.toString());
+  in.imbue(std::locale::classic());
+  double result;
+  in >> result;
+  if(in.fail()) {
+    throw ParsingException("Number is not within the value range of datatype");
+  }
+  return result;
+}
+
+void JsonPullDeserializer::handleValue(bool& data, json::PullParser& state)
+{
+  switch(state.getCurrentTokenType()) {
+  case json::ParseTokenType::True:
+    data = true;
+    return;
+  case json::ParseTokenType::False:
+    data = false;
+    return;
+  case json::ParseTokenType::Number:
+    data = readSignedNumber(state) != 0;
+    return;
+  default:
+    throw ParsingException("Expected Bool");
+  }
+}
+
+void JsonPullDeserializer::handleValue(std::string& data, json::PullParser& state)
+{
+  if(state.getCurrentTokenType() != json::ParseTokenType::String) {
+    throw ParsingException("Expected String");
+  }
+  const misc::ConstStringRef value = state.getCurrentValue();
+  data.assign(value.begin(), value.end());
+}
+
+void JsonPullDeserializer::handleValue(char& data, json::PullParser& state)
+{
+  if(state.getCurrentTokenType() != json::ParseTokenType::String) {
+    throw ParsingException("Expected String");
+  }
+  const misc::ConstStringRef value = state.getCurrentValue();
+  if(value.size() != 1) {
+    throw ParsingException("Expecting string of size 1");
+  }
+  data = value[0];
+}
+
+} // namespace sergut
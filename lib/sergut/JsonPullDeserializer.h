@@ -0,0 +1,498 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "sergut/DeserializerBase.h"
+#include "sergut/ParsingException.h"
+#include "sergut/Util.h"
+#include "sergut/detail/JsonMemberNameIndex.h"
+#include "sergut/json/PullParser.h"
+#include "sergut/misc/ConstStringRef.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <list>
+#include <memory>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace sergut {
+
+/**
+ * \brief Deserializer that binds JSON directly into the target types without
+ *        building a DOM
+ *
+ * In contrast to the \c JsonDeserializer, which parses the whole document into
+ * a rapidjson DOM before walking it, this deserializer pulls the JSON tokens
+ * out of a \c sergut::json::PullParser and stores the values directly in the
+ * members of the target type. Thus memory usage is independent of the size of
+ * the document and the document is traversed only once.
+ *
+ * The semantics are the same as those of the \c JsonDeserializer: the members
+ * may appear in any order, unknown members are skipped, members with the
+ * value \c null are treated as missing, and of duplicate members only the
+ * first one is used. A \c ParsingException is thrown if a mandatory member is
+ * missing.
+ *
+ * \internal
+ * The names of the members of a type are collected once into a
+ * \c detail::JsonMemberNameIndex, which maps a JSON member name to the
+ * position of the member in \c serialize(). For each known member of a JSON
+ * object the \c serialize() function of the target type is called with a
+ * \c MemberMatcher, which deserializes the value into the member at that
+ * position. This costs one integer comparison per declared member, but no
+ * name comparisons. After the object has been closed, \c serialize() is called
+ * once more with a \c MandatoryMemberChecker. All of them identify a member by
+ * its position in \c serialize(), thus \c serialize() must declare the same
+ * members, independent of the data that has been deserialized so far.
+ */
+class JsonPullDeserializer
+{
+public:
+  /**
+   * \brief Create a JsonPullDeserializer copying the \c json into an inner variable.
+   * \param json A string with the JSON data.
+   */
+  JsonPullDeserializer(const std::string& json) : JsonPullDeserializer(sergut::misc::ConstStringRef(json)) { }
+  /**
+   * \brief Create a JsonPullDeserializer copying the \c json into an inner variable.
+   * \param json A ConstStringRef with the JSON data.
+   */
+  JsonPullDeserializer(const misc::ConstStringRef& json);
+  /**
+   * \brief Create a JsonPullDeserializer moving the \c json into an inner variable.
+   * \param json A std::vector with the JSON data that will be moved into the class.
+   */
+  JsonPullDeserializer(std::vector<char>&& json);
+  /**
+   * \brief Create a JsonPullDeserializer that pulls the tokens out of \c parser
+   *
+   * This allows using a parser with a structural index for large documents,
+   * see \c sergut::json::PullParser::createIndexedParser().
+   * \param parser A parser that has not been used yet.
+   */
+  JsonPullDeserializer(std::unique_ptr<json::PullParser>&& parser);
+
+  /**
+   * \brief Deserialize data into type \c DT
+   * \tparam DT The type into which the JSON should be deserialized.
+   */
+  template<typename DT>
+  DT deserializeData() {
+    if(jsonDocument->getCurrentTokenType() != json::ParseTokenType::InitialState) {
+      throw ParsingException("A parser object MUST NOT be used more than once");
+    }
+    DT data;
+    nextToken(*jsonDocument);
+    handleValue(data, *jsonDocument);
+    if(nextToken(*jsonDocument) != json::ParseTokenType::CloseDocument) {
+      throw ParsingException("Unexpected data after the JSON value");
+    }
+    return data;
+  }
+
+  /**
+   * \brief Deserialize the elements of a top level JSON array one by one
+   *
+   * Each element is passed to \c callback right after it has been
+   * deserialized, thus the elements do not have to be kept in memory
+   * together.
+   *
+   * \param callback is called with each element as \c DT&&.
+   * \tparam DT The type into which the elements should be deserialized.
+   * \return The number of elements.
+   */
+  template<typename DT, typename Callback>
+  std::size_t forEachArrayElement(Callback&& callback) {
+    if(jsonDocument->getCurrentTokenType() != json::ParseTokenType::InitialState) {
+      throw ParsingException("A parser object MUST NOT be used more than once");
+    }
+    if(nextToken(*jsonDocument) != json::ParseTokenType::OpenArray) {
+      throw ParsingException("Expecting Collection, but got something else");
+    }
+    std::size_t elementCount = 0;
+    while(nextToken(*jsonDocument) != json::ParseTokenType::CloseArray) {
+      DT data;
+      handleValue(data, *jsonDocument);
+      callback(std::move(data));
+      ++elementCount;
+    }
+    if(nextToken(*jsonDocument) != json::ParseTokenType::CloseDocument) {
+      throw ParsingException("Unexpected data after the JSON value");
+    }
+    return elementCount;
+  }
+
+  /**
+   * \brief Deserialize the elements of a top level JSON array that is read
+   *        out of \c input one by one
+   *
+   * The data is read in chunks of \c chunkSize bytes and the data of the
+   * elements that have been passed on is dropped, thus the memory usage is
+   * bounded by the size of the largest element instead of the size of the
+   * array.
+   *
+   * \param callback is called with each element as \c DT&&.
+   * \tparam DT The type into which the elements should be deserialized.
+   * \return The number of elements.
+   */
+  template<typename DT, typename Callback>
+  static std::size_t forEachArrayElement(std::istream& input, Callback&& callback, const std::size_t chunkSize = 64 * 1024) {
+    std::unique_ptr<json::PullParser> parser = json::PullParser::createParser(misc::ConstStringRef());
+    std::vector<char> chunk(std::max(chunkSize, std::size_t(1)));
+    const auto appendChunk = [&]() {
+      if(!input.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) && input.gcount() == 0) {
+        return false;
+      }
+      parser->appendData(chunk.data(), static_cast<std::size_t>(input.gcount()));
+      return true;
+    };
+    const auto parseNext = [&]() {
+      while(parser->parseNext() == json::ParseTokenType::IncompleteDocument && appendChunk()) { }
+      checkToken(*parser);
+      return parser->getCurrentTokenType();
+    };
+    if(parseNext() != json::ParseTokenType::OpenArray) {
+      throw ParsingException("Expecting Collection, but got something else");
+    }
+    std::size_t elementCount = 0;
+    parseNext();
+    while(parser->getCurrentTokenType() != json::ParseTokenType::CloseArray) {
+      parser->setSavePointAtCurrentToken();
+      // The element is deserialized again after appending more data, if it
+      // is incomplete. Appending twice as much data for each retry keeps the
+      // effort linear in the size of the element.
+      for(std::size_t retryChunkCount = 1; ; retryChunkCount *= 2) {
+        try {
+          callback(deserializeFromSnippet<DT>(*parser));
+          break;
+        } catch(const ParsingException&) {
+          if(parser->getCurrentTokenType() != json::ParseTokenType::IncompleteDocument || !appendChunk()) {
+            throw;
+          }
+          for(std::size_t i = 1; i < retryChunkCount && appendChunk(); ++i) { }
+          parser->restoreToSavePoint();
+        }
+      }
+      ++elementCount;
+      // deserializeFromSnippet() has already parsed the token after the element
+      if(parser->getCurrentTokenType() == json::ParseTokenType::IncompleteDocument) {
+        parseNext();
+      }
+      checkToken(*parser);
+    }
+    // the parser reports the end of the document at the end of the appended
+    // data, thus the rest of the input is checked separately
+    if(parseNext() != json::ParseTokenType::CloseDocument) {
+      throw ParsingException("Unexpected data after the JSON value");
+    }
+    while(input.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || input.gcount() != 0) {
+      const char* chunkBegin = chunk.data();
+      const char* chunkEnd = chunkBegin + input.gcount();
+      if(std::find_if(chunkBegin, chunkEnd, [](const char c) { return c != ' ' && c != '\t' && c != '\n' && c != '\r'; }) != chunkEnd) {
+        throw ParsingException("Unexpected data after the JSON value");
+      }
+    }
+    return elementCount;
+  }
+
+  /**
+   * \brief Deserialize a JSON value out of a running \c sergut::json::PullParser
+   *
+   * This can be used to deserialize the elements of a long array one by one.
+   * Together with \c sergut::json::PullParser::appendData() the processing of
+   * the elements can start even before the complete document has been received.
+   *
+   * Check the unit test "Deserialize JSON snippets" for an example how this can
+   * be done.
+   *
+   * \param currentJsonToken a \c sergut::json::PullParser that must be
+   *        positioned at the first token of the value that should be
+   *        deserialized. Afterwards it is positioned at the token following
+   *        the value, which is \c IncompleteDocument if that token has not
+   *        been received yet.
+   * \tparam DT The type into which the JSON should be deserialized.
+   * \throws ParsingException if the value is invalid or if it is not complete.
+   *         In the latter case the parser is left in the state
+   *         \c IncompleteDocument and can be returned to a save point, that
+   *         was set at the first token of the value, to try again after more
+   *         data has been appended.
+   */
+  template<typename DT>
+  static DT deserializeFromSnippet(json::PullParser& currentJsonToken) {
+    DT data;
+    handleValue(data, currentJsonToken);
+    currentJsonToken.parseNext();
+    return data;
+  }
+
+private:
+  /// The positions in \c serialize() of the members that have been deserialized
+  class MemberSet {
+  public:
+    void insert(const std::size_t memberIndex) {
+      if(memberIndex < 64) {
+        bits |= uint64_t(1) << memberIndex;
+        return;
+      }
+      if(overflow.size() <= memberIndex - 64) {
+        overflow.resize(memberIndex - 63);
+      }
+      overflow[memberIndex - 64] = true;
+    }
+    bool contains(const std::size_t memberIndex) const {
+      if(memberIndex < 64) {
+        return (bits & (uint64_t(1) << memberIndex)) != 0;
+      }
+      return memberIndex - 64 < overflow.size() && overflow[memberIndex - 64];
+    }
+  private:
+    uint64_t bits = 0;
+    std::vector<bool> overflow;
+  };
+
+  /// Collects the names of the members into a \c detail::JsonMemberNameIndex
+  class MemberNameCollector: public DeserializerBase {
+  public:
+    MemberNameCollector(detail::JsonMemberNameIndex& pMemberNames) : memberNames(pMemberNames) { }
+
+    template<typename DT>
+    MemberNameCollector& operator&(const NamedMemberForDeserialization<DT>& data) {
+      memberNames.add(data.name);
+      return *this;
+    }
+
+    /// Not relevant for JSON
+    MemberNameCollector& operator&(const ChildrenFollow&) { return *this; }
+
+    /// Not relevant for JSON
+    MemberNameCollector& operator&(const PlainChildFollows&) { return *this; }
+
+  private:
+    detail::JsonMemberNameIndex& memberNames;
+  };
+
+  /// Deserializes the current value into the member at the given position
+  class MemberMatcher: public DeserializerBase {
+  public:
+    MemberMatcher(const std::size_t pMemberIndex, json::PullParser& pState, MemberSet& pFoundMembers)
+      : memberIndex(pMemberIndex), state(pState), foundMembers(pFoundMembers)
+    { }
+
+    template<typename DT>
+    MemberMatcher& operator&(const NamedMemberForDeserialization<DT>& data) {
+      if(nextMemberIndex++ == memberIndex) {
+        handleValue(data.data, state);
+        foundMembers.insert(memberIndex);
+      }
+      return *this;
+    }
+
+    /// Not relevant for JSON
+    MemberMatcher& operator&(const ChildrenFollow&) { return *this; }
+
+    /// Not relevant for JSON
+    MemberMatcher& operator&(const PlainChildFollows&) { return *this; }
+
+  private:
+    const std::size_t memberIndex;
+    json::PullParser& state;
+    MemberSet& foundMembers;
+    std::size_t nextMemberIndex = 0;
+  };
+
+  /// Throws if a mandatory member has not been deserialized
+  class MandatoryMemberChecker: public DeserializerBase {
+  public:
+    MandatoryMemberChecker(const MemberSet& pFoundMembers) : foundMembers(pFoundMembers) { }
+
+    template<typename DT>
+    MandatoryMemberChecker& operator&(const NamedMemberForDeserialization<DT>& data) {
+      if(data.mandatory && !foundMembers.contains(nextMemberIndex)) {
+        throw ParsingException(std::string("Missing mandatory member '") + data.name + "'");
+      }
+      ++nextMemberIndex;
+      return *this;
+    }
+
+    /// Not relevant for JSON
+    MandatoryMemberChecker& operator&(const ChildrenFollow&) { return *this; }
+
+    /// Not relevant for JSON
+    MandatoryMemberChecker& operator&(const PlainChildFollows&) { return *this; }
+
+  private:
+    const MemberSet& foundMembers;
+    std::size_t nextMemberIndex = 0;
+  };
+
+private:
+  /// Throws if the current token is not valid
+  static void checkToken(const json::PullParser& state);
+  /// Pulls the next token out of the parser and throws if the JSON is invalid
+  static json::ParseTokenType nextToken(json::PullParser& state);
+  /// Skips the value at the current token including all nested values
+  static void skipValue(json::PullParser& state);
+
+  static long long readSignedNumber(const json::PullParser& state);
+  static unsigned long long readUnsignedNumber(const json::PullParser& state);
+  static double readDouble(const json::PullParser& state);
+
+  // The handleValue() functions expect the parser to be positioned on the
+  // first token of the value and leave it on its last token.
+
+  // Signed integers
+  template<typename T>
+  static typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, void>::type
+  handleValue(T& data, json::PullParser& state) {
+    const long long value = readSignedNumber(state);
+    if(value < static_cast<long long>(std::numeric_limits<T>::min())
+       || value > static_cast<long long>(std::numeric_limits<T>::max()))
+    {
+      throw ParsingException("Number is not within the value range of datatype");
+    }
+    data = static_cast<T>(value);
+  }
+
+  // Unsigned integers
+  template<typename T>
+  static typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value, void>::type
+  handleValue(T& data, json::PullParser& state) {
+    const unsigned long long value = readUnsignedNumber(state);
+    if(value > static_cast<unsigned long long>(std::numeric_limits<T>::max())) {
+      throw ParsingException("Number is not within the value range of datatype");
+    }
+    data = static_cast<T>(value);
+  }
+
+  template<typename T>
+  static typename std::enable_if<std::is_floating_point<T>::value, void>::type
+  handleValue(T& data, json::PullParser& state) {
+    data = static_cast<T>(readDouble(state));
+  }
+
+  static void handleValue(bool& data, json::PullParser& state);
+
+  // String types
+  static void handleValue(std::string& data, json::PullParser& state);
+  static void handleValue(char& data, json::PullParser& state);
+  static void handleValue(char*& data, json::PullParser& state) = delete;
+
+  template<typename Collection>
+  static void insertIntoCollection(Collection& collection, typename Collection::value_type&& data) {
+    collection.push_back(std::move(data));
+  }
+
+  template<typename CDT>
+  static void insertIntoCollection(std::set<CDT>& collection, CDT&& data) {
+    collection.insert(std::move(data));
+  }
+
+  // Containers as members
+  template<typename Collection>
+  static void handleCollection(Collection& data, json::PullParser& state) {
+    if(state.getCurrentTokenType() != json::ParseTokenType::OpenArray) {
+      throw ParsingException("Expecting Collection, but got something else");
+    }
+    while(nextToken(state) != json::ParseTokenType::CloseArray) {
+      typename Collection::value_type el;
+      handleValue(el, state);
+      insertIntoCollection(data, std::move(el));
+    }
+  }
+
+  template<typename CDT>
+  static void handleValue(std::vector<CDT>& data, json::PullParser& state) {
+    handleCollection(data, state);
+  }
+
+  template<typename CDT>
+  static void handleValue(std::list<CDT>& data, json::PullParser& state) {
+    handleCollection(data, state);
+  }
+
+  template<typename CDT>
+  static void handleValue(std::set<CDT>& data, json::PullParser& state) {
+    handleCollection(data, state);
+  }
+
+  // Members that can be converted to string
+  template<typename DT>
+  static auto handleValue(DT& data, json::PullParser& state)
+  -> decltype(deserializeFromString(data, std::string()),void())
+  {
+    if(state.getCurrentTokenType() != json::ParseTokenType::String) {
+      throw ParsingException("Expecting String, but got something else");
+    }
+    deserializeFromString(data, state.getCurrentValue().toString());
+  }
+
+  // structured data
+  template<typename DT>
+  static auto handleValue(DT& data, json::PullParser& state)
+  -> decltype(serialize(DummyDeserializer::dummyInstance(), data, static_cast<typename std::decay<DT>::type*>(nullptr)),void())
+  {
+    if(state.getCurrentTokenType() != json::ParseTokenType::OpenObject) {
+      throw ParsingException("Expecting Object, but got something else");
+    }
+    detail::JsonMemberNameIndex& memberNames = detail::JsonMemberNameIndex::forType<typename std::decay<DT>::type>();
+    if(!memberNames.isBuilt()) {
+      MemberNameCollector collector(memberNames);
+      serialize(collector, data, static_cast<typename std::decay<DT>::type*>(nullptr));
+      memberNames.finishBuilding();
+    }
+    // the members that have been deserialized
+    MemberSet foundMembers;
+    // the members that have occurred in the JSON, including those set to null
+    MemberSet seenMembers;
+    while(nextToken(state) == json::ParseTokenType::MemberName) {
+      const misc::ConstStringRef name = state.getCurrentMemberName();
+      const std::size_t memberIndex = memberNames.find(name.begin(), name.size());
+      nextToken(state);
+      if(memberIndex == detail::JsonMemberNameIndex::notFound || seenMembers.contains(memberIndex)) {
+        // unknown or duplicate member, like the JsonDeserializer only the first one is used
+        skipValue(state);
+        continue;
+      }
+      seenMembers.insert(memberIndex);
+      if(state.getCurrentTokenType() == json::ParseTokenType::Null) {
+        // null is treated like a missing member
+        continue;
+      }
+      MemberMatcher matcher(memberIndex, state, foundMembers);
+      serialize(matcher, data, static_cast<typename std::decay<DT>::type*>(nullptr));
+    }
+    // nextToken() throws on invalid JSON, so this is the end of the object
+    MandatoryMemberChecker checker(foundMembers);
+    serialize(checker, data, static_cast<typename std::decay<DT>::type*>(nullptr));
+  }
+
+private:
+  std::unique_ptr<json::PullParser> jsonDocument;
+};
+
+} // namespace sergut
@@ -21,28 +21,59 @@
 
 #include "sergut/JsonSerializer.h"
 
-#include "sergut/Misc.h"
+#include "sergut/misc/EscapeScanner.h"
+#include "sergut/misc/NumberFormatter.h"
 
-#include <iomanip>
-#include <map>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
 #include <vector>
 
 namespace sergut {
 
 struct JsonSerializer::LevelStatus {
   bool firstOfLevel = true;
+  /// keys of the members of the type serialized on this level
+  detail::JsonKeyCache* keyCache = nullptr;
+  std::size_t memberIndex = 0;
 };
 
 struct JsonSerializer::Impl {
+  Impl(misc::OutputSink* pSink)
+    : ownSink(pSink == nullptr ? new misc::StringSink : nullptr)
+    , sink(pSink == nullptr ? ownSink.get() : pSink)
+  { }
+  Impl(const Impl&) = delete;
+  Impl& operator=(const Impl&) = delete;
+
+  misc::StringSink& getOwnSink(const char* function) const {
+    if(!ownSink) {
+      throw std::logic_error(std::string("JsonSerializer::") + function + "() is not available when writing into an external sink");
+    }
+    return *ownSink;
+  }
+
+public:
   std::vector<LevelStatus> levelStatus;
-  std::ostringstream out;
+  std::unique_ptr<misc::StringSink> ownSink;
+  misc::OutputSink* sink;
   uint8_t flags = static_cast<uint8_t>(Flags::None);
+  misc::ThreadPool* threadPool = nullptr;
+  std::size_t parallelChunkSize = 0;
 };
 
 
 
 JsonSerializer::JsonSerializer(const Flags flags)
-  : impl(new Impl)
+  : impl(new Impl(nullptr))
+{
+  impl->flags = static_cast<uint8_t>(flags);
+  impl->levelStatus.push_back(LevelStatus{});
+}
+
+JsonSerializer::JsonSerializer(misc::OutputSink& sink, const Flags flags)
+  : impl(new Impl(&sink))
 {
   impl->flags = static_cast<uint8_t>(flags);
   impl->levelStatus.push_back(LevelStatus{});
@@ -63,69 +94,167 @@ JsonSerializer::~JsonSerializer() {
 
 std::string JsonSerializer::str() const
 {
-  return impl->out.str();
+  return impl->getOwnSink("str").data();
+}
+
+std::string JsonSerializer::take()
+{
+  return impl->getOwnSink("take").take();
+}
+
+const std::string& JsonSerializer::data() const
+{
+  return impl->getOwnSink("data").data();
+}
+
+void JsonSerializer::flush()
+{
+  impl->sink->flush();
+}
+
+void JsonSerializer::reset()
+{
+  if(impl->levelStatus.size() != 1) {
+    throw std::logic_error("JsonSerializer::reset() must not be called while serializing");
+  }
+  impl->levelStatus.back() = LevelStatus{};
+  if(impl->ownSink) {
+    impl->ownSink->clear();
+  }
+}
+
+void JsonSerializer::setThreadPool(misc::ThreadPool* threadPool, const std::size_t chunkSize)
+{
+  impl->threadPool = threadPool;
+  impl->parallelChunkSize = std::max(chunkSize, std::size_t(1));
+}
+
+bool JsonSerializer::isParallelCollection(const std::size_t size) const
+{
+  return impl->threadPool != nullptr && size > impl->parallelChunkSize;
+}
+
+void JsonSerializer::serializeChunksInParallel(const std::size_t size, const ChunkSerializer& serializeChunk)
+{
+  const std::size_t chunkSize = impl->parallelChunkSize;
+  const Flags flags = static_cast<Flags>(impl->flags);
+  std::vector<std::string> chunks((size + chunkSize - 1) / chunkSize);
+  impl->threadPool->parallelFor(chunks.size(), [&](const std::size_t chunk) {
+    JsonSerializer ser(flags);
+    const std::size_t begin = chunk * chunkSize;
+    serializeChunk(ser, begin, std::min(size, begin + chunkSize));
+    chunks[chunk] = ser.take();
+  });
+  for(std::size_t i = 0; i < chunks.size(); ++i) {
+    if(i != 0) {
+      out().write(',');
+    }
+    out().write(chunks[i].data(), chunks[i].size());
+  }
+}
+
+void JsonSerializer::serializeValue(const long long data)
+{
+  char buf[misc::NumberFormatter::maxLength];
+  out().write(buf, misc::NumberFormatter::format(buf, data) - buf);
+}
+
+void JsonSerializer::serializeValue(const unsigned long long data)
+{
+  char buf[misc::NumberFormatter::maxLength];
+  out().write(buf, misc::NumberFormatter::format(buf, data) - buf);
+}
+
+void JsonSerializer::serializeValue(const double data)
+{
+  char buf[misc::NumberFormatter::maxLength];
+  out().write(buf, misc::NumberFormatter::format(buf, data) - buf);
+}
+
+void JsonSerializer::serializeValue(const float data)
+{
+  char buf[misc::NumberFormatter::maxLength];
+  out().write(buf, misc::NumberFormatter::format(buf, data) - buf);
 }
 
 void JsonSerializer::serializeValue(const bool data) {
   if(impl->flags & static_cast<uint8_t>(Flags::BoolAsInt)) {
-    out() << (data ? 1 : 0);
+    out().write(data ? '1' : '0');
+  } else if(data) {
+    out().write("true", 4);
   } else {
-    out() << (data ? "true" : "false");
+    out().write("false", 5);
   }
 }
 
 static
-const std::map<char, std::string>& specialCharacters() {
-  static const std::map<char, std::string> entities{
-    {'"' ,  "\\\"" },
-    {'\\',  "\\\\" },
-    {'\b',  "\\b"  },
-    {'\f',  "\\f"  },
-    {'\n',  "\\n"  },
-    {'\r',  "\\r"  },
-    {'\t',  "\\t"  },
-  };
-  return entities;
+void writeEscapedChar(misc::OutputSink& ostr, const char c)
+{
+  switch(c) {
+  case '"':  ostr.write("\\\"", 2); break;
+  case '\\': ostr.write("\\\\", 2); break;
+  case '\b': ostr.write("\\b", 2);  break;
+  case '\f': ostr.write("\\f", 2);  break;
+  case '\n': ostr.write("\\n", 2);  break;
+  case '\r': ostr.write("\\r", 2);  break;
+  case '\t': ostr.write("\\t", 2);  break;
+  default: {
+    // other non-printable
+    static const char hexDigits[] = "0123456789abcdef";
+    const unsigned char ci = static_cast<unsigned char>(c);
+    const char escaped[] = { '\\', 'u', '0', '0', hexDigits[ci >> 4], hexDigits[ci & 0x0f] };
+    ostr.write(escaped, sizeof(escaped));
+  }
+  }
 }
 
 static
-bool isPrintable(const char c) {
-  const unsigned char ci = static_cast<unsigned char>(c);
-  const unsigned char limit = 0x20;
-  return ci >= limit;
+void writeEscapedTo(misc::OutputSink& ostr, const char* regionStart, const char* const end)
+{
+  while(true) {
+    const char* const regionEnd = misc::EscapeScanner::findJsonSpecial(regionStart, end);
+    if(regionEnd != regionStart) {
+      ostr.write(regionStart, regionEnd - regionStart);
+    }
+    if(regionEnd == end) {
+      return;
+    }
+    writeEscapedChar(ostr, *regionEnd);
+    regionStart = regionEnd + 1;
+  }
 }
 
 void JsonSerializer::writeEscaped(const std::string &str)
 {
-  std::ostringstream& ostr = impl->out;
-  std::string::const_iterator regionStartIt = str.begin();
-  std::string::const_iterator regionEndIt = str.begin();
-  const std::map<char, std::string>& entities = specialCharacters();
-  while(regionEndIt != str.end()) {
-    std::map<char, std::string>::const_iterator entityIt = entities.find(*regionEndIt);
-    const bool isNonPrintable = !isPrintable(*regionEndIt);
-    if(entityIt != entities.end() || isNonPrintable) {
-      // found XML-Entity character
-      if(regionStartIt != regionEndIt) {
-        ostr.write(&*regionStartIt, regionEndIt-regionStartIt);
-      }
-      if(entityIt != entities.end()) {
-        const std::string& entity = entityIt->second;
-        ostr.write(entity.data(), entity.size());
-      } else {
-        // other non-printable
-        StreamFormatBackup formatGuard(ostr);
-        ostr << "\\u" << std::setfill('0') << std::setw(4) << std::hex << (unsigned int)*regionEndIt;
-      }
-      ++regionEndIt;
-      regionStartIt = regionEndIt;
-    } else {
-      ++regionEndIt;
+  writeEscapedTo(*impl->sink, str.data(), str.data() + str.size());
+}
+
+void JsonSerializer::writeKey(const char* name)
+{
+  LevelStatus& level = impl->levelStatus.back();
+  if(level.keyCache != nullptr) {
+    const std::size_t index = level.memberIndex++;
+    const std::size_t length = std::strlen(name);
+    const std::string* key = level.keyCache->find(index, name, length);
+    if(key == nullptr) {
+      misc::StringSink keySink;
+      keySink.write('"');
+      writeEscapedTo(keySink, name, name + length);
+      keySink.write("\":", 2);
+      key = &level.keyCache->insert(index, name, length, keySink.take());
     }
+    impl->sink->write(key->data(), key->size());
+    return;
   }
-  if(regionEndIt != regionStartIt) {
-    ostr.write(&*regionStartIt, regionEndIt-regionStartIt);
-  }
+  misc::OutputSink& ostr = *impl->sink;
+  ostr.write('"');
+  writeEscapedTo(ostr, name, name + std::strlen(name));
+  ostr.write("\":", 2);
+}
+
+void JsonSerializer::setKeyCache(detail::JsonKeyCache& keyCache)
+{
+  impl->levelStatus.back().keyCache = &keyCache;
 }
 
 void JsonSerializer::addCommaIfNeeded()
@@ -134,13 +263,13 @@ void JsonSerializer::addCommaIfNeeded()
   if(firstOfLevel) {
     firstOfLevel = false;
   } else {
-    impl->out << ",";
+    impl->sink->write(',');
   }
 }
 
-std::ostream &JsonSerializer::out()
+misc::OutputSink& JsonSerializer::out()
 {
-  return impl->out;
+  return *impl->sink;
 }
 
 } // namespace sergut
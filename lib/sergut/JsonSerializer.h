@@ -24,10 +24,14 @@
 #include "sergut/SerializerBase.h"
 #include "sergut/Util.h"
 #include "sergut/detail/DummySerializer.h"
+#include "sergut/detail/JsonKeyCache.h"
+#include "sergut/misc/OutputSink.h"
+#include "sergut/misc/ThreadPool.h"
 
+#include <functional>
 #include <list>
 #include <set>
-#include <sstream>
+#include <string>
 #include <vector>
 
 namespace sergut {
@@ -41,35 +45,56 @@ public:
     None = 0,
     BoolAsInt = 1  // set by default for backward-compatibility
   };
+  /// \brief Create a JsonSerializer that writes into an internal buffer
   JsonSerializer(const Flags flags = Flags::BoolAsInt);
+  /**
+   * \brief Create a JsonSerializer that writes into \c sink
+   *
+   * The sink must outlive the serializer. Call \c flush() when done
+   * serializing to ensure that all data has been handed over to the sink.
+   *
+   * To stream large documents with bounded memory use a
+   * \c misc::BufferedSink such as \c misc::FileDescriptorSink or
+   * \c misc::CallbackSink. It hands over the output in chunks of its buffer
+   * size while the data is being serialized:
+   * \code
+   * sergut::misc::FileDescriptorSink sink(fd);
+   * sergut::JsonSerializer ser(sink);
+   * ser.serializeData(hugeData);
+   * ser.flush();
+   * \endcode
+   */
+  JsonSerializer(misc::OutputSink& sink, const Flags flags = Flags::BoolAsInt);
   JsonSerializer(const JsonSerializer& ref);
   ~JsonSerializer();
 
   template<typename DT>
   JsonSerializer& operator&(const NamedMemberForSerialization<DT>& data) {
     addCommaIfNeeded();
-    if(data.name) { out() << "\"" << data.name << "\":"; }
+    if(data.name) {
+      writeKey(data.name);
+    }
     serializeValue(data.data);
     return *this;
   }
 
-  void serializeValue(const long long data) { out() << data; }
-  void serializeValue(const long data) { out() << data; }
-  void serializeValue(const int data) { out() << data; }
-  void serializeValue(const short data) { out() << data; }
-  void serializeValue(const signed char data) { out() << static_cast<short>(data); }
-  void serializeValue(const unsigned long long data) { out() << data; }
-  void serializeValue(const unsigned long data) { out() << data; }
-  void serializeValue(const unsigned int data) { out() << data; }
-  void serializeValue(const unsigned short data) { out() << data; }
-  void serializeValue(const unsigned char data) { out() << static_cast<unsigned short>(data); }
-  void serializeValue(const double data) { out() << data; }
-  void serializeValue(const float data) { out() << data; }
+  void serializeValue(const long long data);
+  void serializeValue(const long data) { serializeValue(static_cast<long long>(data)); }
+  void serializeValue(const int data) { serializeValue(static_cast<long long>(data)); }
+  void serializeValue(const short data) { serializeValue(static_cast<long long>(data)); }
+  void serializeValue(const signed char data) { serializeValue(static_cast<long long>(data)); }
+  void serializeValue(const unsigned long long data);
+  void serializeValue(const unsigned long data) { serializeValue(static_cast<unsigned long long>(data)); }
+  void serializeValue(const unsigned int data) { serializeValue(static_cast<unsigned long long>(data)); }
+  void serializeValue(const unsigned short data) { serializeValue(static_cast<unsigned long long>(data)); }
+  void serializeValue(const unsigned char data) { serializeValue(static_cast<unsigned long long>(data)); }
+  void serializeValue(const double data);
+  void serializeValue(const float data);
   void serializeValue(const bool data);
   void serializeValue(const std::string& data) {
-    out() << "\"";
+    out().write('"');
     writeEscaped(data);
-    out() << "\"";
+    out().write('"');
   }
   void serializeValue(const char data[]) { serializeValue(std::string(data)); }
   void serializeValue(const char*& data) { serializeValue(std::string(data)); }
@@ -78,23 +103,36 @@ public:
   // Containers as members
   template<typename DT>
   void serializeCollection(const DT& data) {
-    out() << "[";
+    out().write('[');
     bool first=true;
     for(auto&& value: data) {
       if(!first) {
-        out() << ",";
+        out().write(',');
       } else {
         first=false;
       }
       JsonSerializer ser(*this);
       ser.serializeValue(value);
     }
-    out() << "]";
+    out().write(']');
   }
 
   template<typename ValueType>
   void serializeValue(const std::vector<ValueType>& data) {
-    return serializeCollection(data);
+    if(!isParallelCollection(data.size())) {
+      return serializeCollection(data);
+    }
+    out().write('[');
+    serializeChunksInParallel(data.size(), [&data](JsonSerializer& ser, const std::size_t begin, const std::size_t end) {
+      for(std::size_t i = begin; i != end; ++i) {
+        if(i != begin) {
+          ser.out().write(',');
+        }
+        JsonSerializer child(ser);
+        child.serializeValue(data[i]);
+      }
+    });
+    out().write(']');
   }
 
   template<typename ValueType>
@@ -111,10 +149,11 @@ public:
   auto serializeValue(const DT& data)
   -> decltype(serialize(detail::DummySerializer::dummyInstance(), data, static_cast<typename std::decay<DT>::type*>(nullptr)), void())
   {
-    out() << "{";
+    out().write('{');
     JsonSerializer ser(*this);
+    ser.setKeyCache(detail::JsonKeyCache::forType<typename std::decay<DT>::type>());
     serialize(ser, data, static_cast<typename std::decay<DT>::type*>(nullptr));
-    out() << "}";
+    out().write('}');
   }
 
   // Members that can be converted to string
@@ -137,12 +176,63 @@ public:
     serializeValue(data);
   }
 
+  /// \brief Get a copy of the serialized data
+  /// \note only available if the serializer writes into its internal buffer
   std::string str() const;
 
+  /**
+   * \brief Hand over the serialized data without copying it
+   *
+   * Afterwards the internal buffer is empty.
+   * \note only available if the serializer writes into its internal buffer
+   */
+  std::string take();
+
+  /**
+   * \brief Access the serialized data without copying it
+   *
+   * The reference is valid until the serializer is written to, reset or
+   * destroyed.
+   * \note only available if the serializer writes into its internal buffer
+   */
+  const std::string& data() const;
+
+  /// \brief Hand over all data to the sink
+  void flush();
+
+  /**
+   * \brief Serialize large \c std::vector members in parallel
+   *
+   * Vectors with more than \c chunkSize elements are split into chunks, that
+   * are serialized by \c threadPool into separate buffers. These are joined
+   * in order, so the output is identical to the sequential one. Collections
+   * within the chunks are serialized sequentially.
+   *
+   * \param threadPool Must outlive the serializer, \c nullptr switches back
+   *        to sequential serialization.
+   */
+  void setThreadPool(misc::ThreadPool* threadPool, const std::size_t chunkSize = 1024);
+
+  /**
+   * \brief Prepare the serializer for the next document
+   *
+   * The internal buffer is emptied, but keeps its capacity, so that
+   * serializing documents of similar size does not allocate memory again.
+   * When writing into an external sink, only the state of the serializer
+   * is reset. Must not be called while serializing.
+   */
+  void reset();
+
 private:
+  typedef std::function<void(JsonSerializer& ser, std::size_t begin, std::size_t end)> ChunkSerializer;
+
+  bool isParallelCollection(const std::size_t size) const;
+  void serializeChunksInParallel(const std::size_t size, const ChunkSerializer& serializeChunk);
   void writeEscaped(const std::string& str);
+  void writeKey(const char* name);
+  void setKeyCache(detail::JsonKeyCache& keyCache);
   void addCommaIfNeeded();
-  std::ostream& out();
+  misc::OutputSink& out();
 
 private:
   Impl* impl;
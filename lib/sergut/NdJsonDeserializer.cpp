@@ -0,0 +1,113 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "sergut/NdJsonDeserializer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace sergut {
+
+static bool isBlank(const char* begin, const char* end)
+{
+  for(; begin != end; ++begin) {
+    if(*begin != ' ' && *begin != '\t') {
+      return false;
+    }
+  }
+  return true;
+}
+
+NdJsonDeserializer::NdJsonDeserializer()
+  : parser(json::PullParser::createParser(misc::ConstStringRef()))
+{ }
+
+void NdJsonDeserializer::setThreadPool(misc::ThreadPool* pThreadPool, const RecordOrder pRecordOrder,
+                                       const std::size_t pChunkSize)
+{
+  threadPool = pThreadPool;
+  recordOrder = pRecordOrder;
+  chunkSize = std::max(pChunkSize, std::size_t(1));
+}
+
+void NdJsonDeserializer::appendData(const char* data, const std::size_t size)
+{
+  // drop the lines that have already been processed
+  buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(readOffset));
+  readOffset = 0;
+  buffer.insert(buffer.end(), data, data + size);
+}
+
+bool NdJsonDeserializer::nextRecord()
+{
+  const char* const bufferEnd = buffer.data() + buffer.size();
+  while(readOffset < buffer.size()) {
+    const char* const lineStart = buffer.data() + readOffset;
+    const char* lineEnd = static_cast<const char*>(std::memchr(lineStart, '\n', static_cast<std::size_t>(bufferEnd - lineStart)));
+    if(lineEnd == nullptr) {
+      if(!finished) {
+        // wait for the rest of the line
+        return false;
+      }
+      lineEnd = bufferEnd;
+    }
+    readOffset = std::min(static_cast<std::size_t>(lineEnd - buffer.data()) + 1, buffer.size());
+    ++lineNumber;
+    if(lineEnd != lineStart && lineEnd[-1] == '\r') {
+      --lineEnd;
+    }
+    if(!isBlank(lineStart, lineEnd)) {
+      parser->resetData(misc::ConstStringRef(lineStart, lineEnd));
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<NdJsonDeserializer::Record> NdJsonDeserializer::takeRecords()
+{
+  std::vector<Record> records;
+  const char* const bufferEnd = buffer.data() + buffer.size();
+  const char* lineStart = buffer.data() + readOffset;
+  while(lineStart < bufferEnd) {
+    const char* lineEnd = static_cast<const char*>(std::memchr(lineStart, '\n', static_cast<std::size_t>(bufferEnd - lineStart)));
+    if(lineEnd == nullptr) {
+      if(!finished) {
+        // wait for the rest of the line
+        break;
+      }
+      lineEnd = bufferEnd;
+    }
+    const char* const nextLineStart = lineEnd == bufferEnd ? bufferEnd : lineEnd + 1;
+    ++lineNumber;
+    if(lineEnd != lineStart && lineEnd[-1] == '\r') {
+      --lineEnd;
+    }
+    if(!isBlank(lineStart, lineEnd)) {
+      records.push_back(Record{ misc::ConstStringRef(lineStart, lineEnd), lineNumber });
+    }
+    lineStart = nextLineStart;
+  }
+  readOffset = static_cast<std::size_t>(lineStart - buffer.data());
+  return records;
+}
+
+} // namespace sergut
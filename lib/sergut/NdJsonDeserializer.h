@@ -0,0 +1,282 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "sergut/JsonPullDeserializer.h"
+#include "sergut/ParsingException.h"
+#include "sergut/json/PullParser.h"
+#include "sergut/misc/ConstStringRef.h"
+#include "sergut/misc/ThreadPool.h"
+
+#include <algorithm>
+#include <exception>
+#include <istream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sergut {
+
+/**
+ * \brief Deserializer for newline delimited JSON (NDJSON)
+ *
+ * The input is a sequence of JSON records of the same type that are separated
+ * by newlines. The data can be fed in arbitrary chunks using \c appendData(),
+ * the complete records are then deserialized by \c deserializeRecords(). A
+ * partial record at the end of the data is kept until the rest of it has been
+ * appended, or until \c finish() marks the end of the input.
+ *
+ * The records are deserialized with the \c JsonPullDeserializer, using a
+ * single \c sergut::json::PullParser for all records. Empty lines are skipped
+ * and a '\\r' at the end of a line is ignored.
+ *
+ * With \c setThreadPool() the records are deserialized in parallel.
+ */
+class NdJsonDeserializer
+{
+public:
+  /// The order in which the records are passed on, if deserialized in parallel
+  enum class RecordOrder {
+    InputOrder,  ///< in the order of the input, on the calling thread
+    Unordered    ///< as soon as they are deserialized, on the worker threads
+  };
+
+  NdJsonDeserializer();
+
+  /**
+   * \brief Deserialize the records in parallel on \c threadPool
+   *
+   * \c deserializeRecords() then splits the complete lines of the inner
+   * buffer into chunks of \c chunkSize records, which are deserialized by the
+   * threads of the pool, each with its own parser. The calling thread takes
+   * part in the work.
+   *
+   * With \c RecordOrder::InputOrder the records of all chunks are collected
+   * and passed to the callback in input order after all chunks are done. With
+   * \c RecordOrder::Unordered the callback is called on the worker threads
+   * right after a record has been deserialized, thus it must be thread safe.
+   * The \c std::vector overload of \c deserializeRecords() always keeps the
+   * input order.
+   *
+   * Invalid records are skipped while the other records are deserialized.
+   * Afterwards the \c ParsingException of the first invalid record is thrown
+   * and \c getLineNumber() returns its line.
+   *
+   * \param threadPool Must outlive the deserializer, \c nullptr switches back
+   *        to sequential deserialization.
+   */
+  void setThreadPool(misc::ThreadPool* threadPool, const RecordOrder recordOrder = RecordOrder::InputOrder,
+                     const std::size_t chunkSize = 256);
+
+  /// \brief Append some data to the inner buffer
+  void appendData(const char* data, const std::size_t size);
+  /// \brief Append some data to the inner buffer
+  void appendData(const misc::ConstStringRef& data) { appendData(data.begin(), data.size()); }
+
+  /**
+   * \brief Mark the end of the input
+   *
+   * After this call \c deserializeRecords() also deserializes a last record
+   * that is not terminated by a newline. No more data may be appended.
+   */
+  void finish() { finished = true; }
+
+  /**
+   * \brief Deserialize all complete records out of the inner buffer
+   *
+   * If a record is invalid, a \c ParsingException is thrown. The invalid
+   * record is dropped, so that the deserialization can continue with the next
+   * one; \c getLineNumber() returns the line of the invalid record.
+   *
+   * \param callback is called with each record as \c DT&&.
+   * \tparam DT The type into which the records should be deserialized.
+   * \return The number of records that have been deserialized.
+   */
+  template<typename DT, typename Callback>
+  std::size_t deserializeRecords(Callback&& callback) {
+    if(threadPool != nullptr) {
+      return deserializeRecordsInParallel<DT>(callback, recordOrder);
+    }
+    return deserializeRecordsSequentially<DT>(callback);
+  }
+
+  /**
+   * \brief Deserialize all complete records out of the inner buffer and
+   *        append them to \c records
+   * \tparam DT The type into which the records should be deserialized.
+   * \return The number of records that have been deserialized.
+   */
+  template<typename DT>
+  std::size_t deserializeRecords(std::vector<DT>& records) {
+    const auto append = [&records](DT&& record) { records.push_back(std::move(record)); };
+    if(threadPool != nullptr) {
+      return deserializeRecordsInParallel<DT>(append, RecordOrder::InputOrder);
+    }
+    return deserializeRecordsSequentially<DT>(append);
+  }
+
+  /**
+   * \brief Deserialize all records that can be read out of \c input
+   * \param callback is called with each record as \c DT&&.
+   * \tparam DT The type into which the records should be deserialized.
+   * \return The number of records that have been deserialized.
+   */
+  template<typename DT, typename Callback>
+  static std::size_t deserializeStream(std::istream& input, Callback&& callback) {
+    NdJsonDeserializer deser;
+    std::vector<char> chunk(64 * 1024);
+    std::size_t recordCount = 0;
+    while(input.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || input.gcount() > 0) {
+      deser.appendData(chunk.data(), static_cast<std::size_t>(input.gcount()));
+      recordCount += deser.deserializeRecords<DT>(callback);
+    }
+    deser.finish();
+    return recordCount + deser.deserializeRecords<DT>(callback);
+  }
+
+  /// \brief Get the number of the line of the last record, counting from 1.
+  ///        After a \c ParsingException it is the line of the invalid record.
+  std::size_t getLineNumber() const { return recordLineNumber; }
+
+private:
+  /// A non-empty line of the inner buffer
+  struct Record {
+    misc::ConstStringRef line;
+    std::size_t lineNumber;
+  };
+
+  /// The first invalid record of a chunk
+  struct RecordError {
+    std::size_t lineNumber = 0;
+    std::exception_ptr exception;
+  };
+
+  /// Passes the next non-empty line to the parser, returns false if there is none
+  bool nextRecord();
+  /// Returns all complete non-empty lines of the inner buffer and marks them as processed
+  std::vector<Record> takeRecords();
+
+  template<typename DT, typename Callback>
+  std::size_t deserializeRecordsSequentially(Callback& callback) {
+    std::size_t recordCount = 0;
+    while(nextRecord()) {
+      recordLineNumber = lineNumber;
+      callback(deserializeRecord<DT>(*parser, lineNumber));
+      ++recordCount;
+    }
+    return recordCount;
+  }
+
+  template<typename DT, typename Callback>
+  std::size_t deserializeRecordsInParallel(Callback& callback, const RecordOrder order) {
+    const std::vector<Record> records = takeRecords();
+    if(!records.empty()) {
+      recordLineNumber = records.back().lineNumber;
+    }
+    const std::size_t chunkCount = (records.size() + chunkSize - 1) / chunkSize;
+    std::vector<std::vector<DT>> chunkResults(order == RecordOrder::InputOrder ? chunkCount : 0);
+    std::vector<std::size_t> chunkRecordCounts(chunkCount, 0);
+    std::vector<RecordError> chunkErrors(chunkCount);
+    threadPool->parallelFor(chunkCount, [&](const std::size_t chunk) {
+      const std::size_t begin = chunk * chunkSize;
+      const std::size_t end = std::min(begin + chunkSize, records.size());
+      std::unique_ptr<json::PullParser> chunkParser = json::PullParser::createParser(misc::ConstStringRef());
+      for(std::size_t i = begin; i != end; ++i) {
+        try {
+          chunkParser->resetData(records[i].line);
+          DT data = deserializeRecord<DT>(*chunkParser, records[i].lineNumber);
+          if(order == RecordOrder::InputOrder) {
+            chunkResults[chunk].push_back(std::move(data));
+          } else {
+            callback(std::move(data));
+          }
+          ++chunkRecordCounts[chunk];
+        } catch(const ParsingException&) {
+          if(!chunkErrors[chunk].exception) {
+            chunkErrors[chunk].lineNumber = records[i].lineNumber;
+            chunkErrors[chunk].exception = std::current_exception();
+          }
+        }
+      }
+    });
+    std::size_t recordCount = 0;
+    for(std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+      if(order == RecordOrder::InputOrder) {
+        for(DT& data: chunkResults[chunk]) {
+          callback(std::move(data));
+        }
+        std::vector<DT>().swap(chunkResults[chunk]);
+      }
+      recordCount += chunkRecordCounts[chunk];
+    }
+    for(const RecordError& error: chunkErrors) {
+      if(error.exception) {
+        recordLineNumber = error.lineNumber;
+        std::rethrow_exception(error.exception);
+      }
+    }
+    return recordCount;
+  }
+
+  template<typename DT>
+  static DT deserializeRecord(json::PullParser& parser, const std::size_t lineNumber) {
+    const json::ParseTokenType tokenType = parser.parseNext();
+    if(tokenType == json::ParseTokenType::IncompleteDocument) {
+      throw ParsingException("Incomplete JSON record", lineNumber, 0);
+    }
+    if(tokenType == json::ParseTokenType::Error) {
+      throw ParsingException("Invalid JSON record", lineNumber, 0);
+    }
+    DT data = deserializeRecordValue<DT>(parser, lineNumber);
+    if(parser.getCurrentTokenType() != json::ParseTokenType::CloseDocument) {
+      throw ParsingException("Unexpected data after the JSON record", lineNumber, 0);
+    }
+    return data;
+  }
+
+  template<typename DT>
+  static DT deserializeRecordValue(json::PullParser& parser, const std::size_t lineNumber) {
+    try {
+      return JsonPullDeserializer::deserializeFromSnippet<DT>(parser);
+    } catch(const ParsingException& e) {
+      // the position within the single line parser is of no use to the caller
+      throw ParsingException(std::string("Invalid JSON record: ") + e.what(), lineNumber, 0);
+    }
+  }
+
+private:
+  std::vector<char> buffer;
+  /// The start of the first line in \c buffer that has not been processed
+  std::size_t readOffset = 0;
+  /// The number of lines that have been processed
+  std::size_t lineNumber = 0;
+  /// The line of the last record that has been deserialized or found invalid
+  std::size_t recordLineNumber = 0;
+  bool finished = false;
+  std::unique_ptr<json::PullParser> parser;
+  misc::ThreadPool* threadPool = nullptr;
+  RecordOrder recordOrder = RecordOrder::InputOrder;
+  std::size_t chunkSize = 256;
+};
+
+} // namespace sergut
@@ -27,6 +27,7 @@
 #include "sergut/Util.h"
 #include "sergut/detail/DummySerializer.h"
 #include "sergut/misc/ConstStringRef.h"
+#include "sergut/misc/NumberFormatter.h"
 
 #include <sstream>
 #include <list>
@@ -44,7 +45,7 @@ public:
 
   UrlSerializer& operator&(const NamedMemberForSerialization<long long>& data) {
     addName(_urlNameCombiner(misc::ConstStringRef(_structureName), misc::ConstStringRef(data.name)));
-    _out << data.data;
+    writeNumber(data.data);
     return *this;
   }
   UrlSerializer& operator&(const NamedMemberForSerialization<long>& data) {
@@ -59,7 +60,7 @@ public:
 
   UrlSerializer& operator&(const NamedMemberForSerialization<unsigned long long>& data) {
     addName(_urlNameCombiner(misc::ConstStringRef(_structureName), misc::ConstStringRef(data.name)));
-    _out << data.data;
+    writeNumber(data.data);
     return *this;
   }
   UrlSerializer& operator&(const NamedMemberForSerialization<unsigned long>& data) {
@@ -77,11 +78,13 @@ public:
 
   UrlSerializer& operator&(const NamedMemberForSerialization<double>& data) {
     addName(_urlNameCombiner(misc::ConstStringRef(_structureName), misc::ConstStringRef(data.name)));
-    _out << data.data;
+    writeNumber(data.data);
     return *this;
   }
   UrlSerializer& operator&(const NamedMemberForSerialization<float>& data) {
-    return operator&(toNamedMember(data.name, static_cast<double>(data.data), data.mandatory));
+    addName(_urlNameCombiner(misc::ConstStringRef(_structureName), misc::ConstStringRef(data.name)));
+    writeNumber(data.data);
+    return *this;
   }
 
   UrlSerializer& operator&(const NamedMemberForSerialization<std::string>& data) {
@@ -183,6 +186,12 @@ private:
     _out << name << "=";
   }
 
+  template<typename DT>
+  void writeNumber(const DT data) {
+    char buf[misc::NumberFormatter::maxLength];
+    _out.write(buf, misc::NumberFormatter::format(buf, data) - buf);
+  }
+
   void writeEscaped(const std::string& str);
 
 private:
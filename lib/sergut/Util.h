@@ -287,6 +287,9 @@
    21 if(pullParser->getCurrentTokenType() != sergut::xml::ParseTokenType::CloseTag) throw Exception();
    22 if(pullParser->getCurrentTagName() != std::string("root"))                     throw Exception();
    \endverbatim
+ * Here every element that is cut off is parsed again after the data has been
+ * appended. The \c sergut::XmlSnippetDeserializer avoids this, it returns a
+ * status instead of throwing and continues where it stopped.
  *
  * \subsection deserializeXmlDeserializerTiny XmlDeserializerTiny
  * This deserializer is used as follows:
@@ -100,11 +100,21 @@ XmlDeserializer::XmlDeserializer(const misc::ConstStringRef& xml)
     , xmlDocument(&*ownXmlDocument)
 { }
 
+XmlDeserializer::XmlDeserializer(const misc::ConstStringRef& xml, const xml::PullParser::DataOwnership ownership)
+    : ownXmlDocument(xml::PullParser::createParser(xml, ownership))
+    , xmlDocument(&*ownXmlDocument)
+{ }
+
 XmlDeserializer::XmlDeserializer(std::vector<char>&& xml)
   : ownXmlDocument(xml::PullParser::createParser(std::move(xml)))
   , xmlDocument(&*ownXmlDocument)
 { }
 
+XmlDeserializer::XmlDeserializer(std::unique_ptr<xml::PullParser>&& parser)
+  : ownXmlDocument(std::move(parser))
+  , xmlDocument(&*ownXmlDocument)
+{ }
+
 XmlDeserializer::XmlDeserializer(xml::PullParser& currentXmlNode)
     : xmlDocument(&currentXmlNode)
 { }
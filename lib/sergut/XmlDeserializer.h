@@ -94,11 +94,26 @@ public:
    * \param xml A ConstStringRef with the XML data.
    */
   XmlDeserializer(const misc::ConstStringRef& xml);
+  /**
+   * \brief Create an XmlDeserializer that may parse the \c xml without copying it.
+   * \param xml A ConstStringRef with the XML data.
+   * \param ownership With \c xml::PullParser::DataOwnership::Borrow the
+   *        \c xml has to outlive the XmlDeserializer.
+   */
+  XmlDeserializer(const misc::ConstStringRef& xml, const xml::PullParser::DataOwnership ownership);
   /**
    * \brief Create an XmlDeserializer moving the \c xml into an inner variable.
    * \param xml A std::vector with the XML data that will be moved into the class.
    */
   XmlDeserializer(std::vector<char>&& xml);
+  /**
+   * \brief Create an XmlDeserializer that takes over the ownership of \c parser.
+   *
+   * Use this with \c xml::PullParser::createParserFromFile() to deserialize
+   * a file straight from a read-only memory mapping.
+   * \param parser The PullParser that has not yet been used for parsing.
+   */
+  XmlDeserializer(std::unique_ptr<xml::PullParser>&& parser);
 
 //  /// Initial call to the serializer
 //  /// \param name The name of the outer tag
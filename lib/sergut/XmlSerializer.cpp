@@ -21,7 +21,11 @@
 
 #include "XmlSerializer.h"
 
-#include <map>
+#include "sergut/misc/EscapeScanner.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
 
 namespace sergut {
 
@@ -32,23 +36,46 @@ public:
 };
 
 struct XmlSerializer::Impl {
-  Impl() { }
+  Impl(misc::OutputSink* pSink)
+    : ownSink(pSink == nullptr ? new misc::StringSink : nullptr)
+    , sink(pSink == nullptr ? ownSink.get() : pSink)
+  { }
   Impl(const Impl&) = delete;
   Impl& operator=(const Impl&) = delete;
 
+  void initLevelStatus() {
+    levelStatus.push_back(LevelStatus{});
+    // The initial level allways starts up at Children-level
+    levelStatus.back().valueType = XmlValueType::Child;
+  }
+
+  misc::StringSink& getOwnSink(const char* function) const {
+    if(!ownSink) {
+      throw std::logic_error(std::string("XmlSerializer::") + function + "() is not available when writing into an external sink");
+    }
+    return *ownSink;
+  }
+
 public:
   std::vector<LevelStatus> levelStatus;
-  std::ostringstream out;
+  std::unique_ptr<misc::StringSink> ownSink;
+  misc::OutputSink* sink;
+  misc::ThreadPool* threadPool = nullptr;
+  std::size_t parallelChunkSize = 0;
 };
 
 
 
 XmlSerializer::XmlSerializer()
-  : impl(new Impl)
+  : impl(new Impl(nullptr))
 {
-  impl->levelStatus.push_back(LevelStatus{});
-  // The initial level allways starts up at Children-level
-  impl->levelStatus.back().valueType = XmlValueType::Child;
+  impl->initLevelStatus();
+}
+
+XmlSerializer::XmlSerializer(misc::OutputSink& sink)
+  : impl(new Impl(&sink))
+{
+  impl->initLevelStatus();
 }
 
 XmlSerializer::XmlSerializer(const XmlSerializer &ref)
@@ -67,7 +94,7 @@ XmlSerializer::~XmlSerializer() {
 XmlSerializer &XmlSerializer::operator&(const ChildrenFollow &)
 {
   assert(getValueType()==XmlValueType::Attribute);
-  out() << ">";
+  out().write('>');
   impl->levelStatus.back().valueType = XmlValueType::Child;
   return *this;
 }
@@ -75,61 +102,106 @@ XmlSerializer &XmlSerializer::operator&(const ChildrenFollow &)
 XmlSerializer &XmlSerializer::operator&(const PlainChildFollows &)
 {
   assert(getValueType()==XmlValueType::Attribute);
-  out() << ">";
+  out().write('>');
   impl->levelStatus.back().valueType = XmlValueType::SingleChild;
   return *this;
 }
 
 std::string XmlSerializer::str() const
 {
-  return impl->out.str();
+  return impl->getOwnSink("str").data();
+}
+
+std::string XmlSerializer::take()
+{
+  return impl->getOwnSink("take").take();
+}
+
+const std::string& XmlSerializer::data() const
+{
+  return impl->getOwnSink("data").data();
+}
+
+void XmlSerializer::flush()
+{
+  impl->sink->flush();
+}
+
+void XmlSerializer::reset()
+{
+  if(impl->levelStatus.size() != 1) {
+    throw std::logic_error("XmlSerializer::reset() must not be called while serializing");
+  }
+  impl->levelStatus.clear();
+  impl->initLevelStatus();
+  if(impl->ownSink) {
+    impl->ownSink->clear();
+  }
+}
+
+void XmlSerializer::setThreadPool(misc::ThreadPool* threadPool, const std::size_t chunkSize)
+{
+  impl->threadPool = threadPool;
+  impl->parallelChunkSize = std::max(chunkSize, std::size_t(1));
+}
+
+bool XmlSerializer::isParallelCollection(const std::size_t size) const
+{
+  return impl->threadPool != nullptr && size > impl->parallelChunkSize;
+}
+
+void XmlSerializer::serializeChunksInParallel(const std::size_t size, const ChunkSerializer& serializeChunk)
+{
+  const std::size_t chunkSize = impl->parallelChunkSize;
+  std::vector<std::string> chunks((size + chunkSize - 1) / chunkSize);
+  impl->threadPool->parallelFor(chunks.size(), [&](const std::size_t chunk) {
+    XmlSerializer ser;
+    const std::size_t begin = chunk * chunkSize;
+    serializeChunk(ser, begin, std::min(size, begin + chunkSize));
+    chunks[chunk] = ser.take();
+  });
+  for(const std::string& chunk: chunks) {
+    out().write(chunk.data(), chunk.size());
+  }
 }
 
 static
-const std::map<char, std::string>& xmlEntities() {
-  static const std::map<char, std::string> entities{
-    {'"',  "&quot;"},
-    {'&',  "&amp;" },
-    {'\'', "&apos;"},
-    {'<',  "&lt;"  },
-    {'>',  "&gt;"  },
-  };
-  return entities;
+void writeXmlEntity(misc::OutputSink& ostr, const char c)
+{
+  switch(c) {
+  case '"':  ostr.write("&quot;", 6); break;
+  case '&':  ostr.write("&amp;", 5);  break;
+  case '\'': ostr.write("&apos;", 6); break;
+  case '<':  ostr.write("&lt;", 4);   break;
+  default:   ostr.write("&gt;", 4);   break;
+  }
 }
 
 void XmlSerializer::writeEscaped(const bool data)
 {
   // TODO: make true/false-string configurable
   if(data) {
-    out() << "true";
+    out().write("true", 4);
   } else {
-    out() << "false";
+    out().write("false", 5);
   }
 }
 
 void XmlSerializer::writeEscaped(const std::string& str)
 {
-  std::ostringstream& ostr = impl->out;
-  std::string::const_iterator regionStartIt = str.begin();
-  std::string::const_iterator regionEndIt = str.begin();
-  const std::map<char, std::string>& entities = xmlEntities();
-  while(regionEndIt != str.end()) {
-    std::map<char, std::string>::const_iterator entityIt = entities.find(*regionEndIt);
-    if(entityIt != entities.end()) {
-      // found XML-Entity character
-      if(regionStartIt != regionEndIt) {
-        ostr.write(&*regionStartIt, regionEndIt-regionStartIt);
-      }
-      const std::string& entity = entityIt->second;
-      ostr.write(entity.data(), entity.size());
-      ++regionEndIt;
-      regionStartIt = regionEndIt;
-    } else {
-      ++regionEndIt;
+  misc::OutputSink& ostr = *impl->sink;
+  const char* regionStart = str.data();
+  const char* const end = regionStart + str.size();
+  while(true) {
+    const char* const regionEnd = misc::EscapeScanner::findXmlSpecial(regionStart, end);
+    if(regionEnd != regionStart) {
+      ostr.write(regionStart, regionEnd - regionStart);
     }
-  }
-  if(regionEndIt != regionStartIt) {
-    ostr.write(&*regionStartIt, regionEndIt-regionStartIt);
+    if(regionEnd == end) {
+      return;
+    }
+    writeXmlEntity(ostr, *regionEnd);
+    regionStart = regionEnd + 1;
   }
 }
 
@@ -138,9 +210,9 @@ XmlValueType XmlSerializer::getValueType() const
   return impl->levelStatus.back().valueType;
 }
 
-std::ostringstream &XmlSerializer::out()
+misc::OutputSink& XmlSerializer::out()
 {
-  return impl->out;
+  return *impl->sink;
 }
 
 } // namespace sergut
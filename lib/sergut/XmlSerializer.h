@@ -25,11 +25,15 @@
 #include "sergut/Util.h"
 #include "sergut/XmlValueType.h"
 #include "sergut/detail/DummySerializer.h"
+#include "sergut/misc/NumberFormatter.h"
+#include "sergut/misc/OutputSink.h"
+#include "sergut/misc/ThreadPool.h"
 
 #include <cassert>
+#include <cstring>
+#include <functional>
 #include <list>
 #include <set>
-#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -52,7 +56,15 @@ class XmlSerializer : public SerializerBase
   class Impl;
   class LevelStatus;
 public:
+  /// \brief Create a XmlSerializer that writes into an internal buffer
   XmlSerializer();
+  /**
+   * \brief Create a XmlSerializer that writes into \c sink
+   *
+   * The sink must outlive the serializer. Call \c flush() when done
+   * serializing to ensure that all data has been handed over to the sink.
+   */
+  explicit XmlSerializer(misc::OutputSink& sink);
   XmlSerializer(const XmlSerializer& ref);
   ~XmlSerializer();
 
@@ -124,7 +136,15 @@ public:
 
   template<typename ValueType>
   XmlSerializer& operator&(const NamedMemberForSerialization<std::vector<ValueType>>& data) {
-    return serializeCollection(data);
+    if(getValueType() != XmlValueType::Child || !isParallelCollection(data.data.size())) {
+      return serializeCollection(data);
+    }
+    serializeChunksInParallel(data.data.size(), [&data](XmlSerializer& ser, const std::size_t begin, const std::size_t end) {
+      for(std::size_t i = begin; i != end; ++i) {
+        ser & toNamedMember(data.name, data.data[i], true);
+      }
+    });
+    return *this;
   }
 
 
@@ -157,7 +177,8 @@ public:
     {
       XmlSerializer ser(*this);
       // Render opening tag
-      out() << "<" << data.name;
+      out().write('<');
+      writeName(data.name);
 
       // Render all attributes and children
       serialize(ser, data.data, static_cast<typename std::decay<DT>::type*>(nullptr));
@@ -165,11 +186,13 @@ public:
       // Render closing tag
       switch(getValueType()) {
       case XmlValueType::Attribute:
-        out() << "/>";
+        out().write("/>", 2);
         break;
       case XmlValueType::Child:
       case XmlValueType::SingleChild:
-        out() << "</" << data.name << ">";
+        out().write("</", 2);
+        writeName(data.name);
+        out().write('>');
         break;
       }
     }
@@ -200,7 +223,8 @@ public:
                            const DT& data)
   {
     // Render opening tag
-    out() << "<" << outerName;
+    out().write('<');
+    writeName(outerName);
 
     XmlSerializer ser(*this);
     switch(xmlValueType) {
@@ -219,18 +243,70 @@ public:
     // Render closing tag
     switch(getValueType()) {
     case XmlValueType::Attribute:
-      out() << "/>";
+      out().write("/>", 2);
       break;
     case XmlValueType::Child:
     case XmlValueType::SingleChild:
-      out() << "</" << outerName << ">";
+      out().write("</", 2);
+      writeName(outerName);
+      out().write('>');
       break;
     }
   }
 
+  /// \brief Get a copy of the serialized data
+  /// \note only available if the serializer writes into its internal buffer
   std::string str() const;
 
+  /**
+   * \brief Hand over the serialized data without copying it
+   *
+   * Afterwards the internal buffer is empty.
+   * \note only available if the serializer writes into its internal buffer
+   */
+  std::string take();
+
+  /**
+   * \brief Access the serialized data without copying it
+   *
+   * The reference is valid until the serializer is written to, reset or
+   * destroyed.
+   * \note only available if the serializer writes into its internal buffer
+   */
+  const std::string& data() const;
+
+  /// \brief Hand over all data to the sink
+  void flush();
+
+  /**
+   * \brief Prepare the serializer for the next document
+   *
+   * The internal buffer is emptied, but keeps its capacity, so that
+   * serializing documents of similar size does not allocate memory again.
+   * When writing into an external sink, only the state of the serializer
+   * is reset. Must not be called while serializing.
+   */
+  void reset();
+
+  /**
+   * \brief Serialize large \c std::vector members in parallel
+   *
+   * Vectors with more than \c chunkSize elements are split into chunks, that
+   * are serialized by \c threadPool into separate buffers. These are joined
+   * in order, so the output is identical to the sequential one. Collections
+   * within the chunks are serialized sequentially.
+   *
+   * \param threadPool Must outlive the serializer, \c nullptr switches back
+   *        to sequential serialization.
+   */
+  void setThreadPool(misc::ThreadPool* threadPool, const std::size_t chunkSize = 1024);
+
 private:
+  typedef std::function<void(XmlSerializer& ser, std::size_t begin, std::size_t end)> ChunkSerializer;
+
+  bool isParallelCollection(const std::size_t size) const;
+  void serializeChunksInParallel(const std::size_t size, const ChunkSerializer& serializeChunk);
+
   template<typename DT>
   XmlSerializer& writeSimpleType(const NamedMemberForSerialization<DT>& data) {
     switch(getValueType()) {
@@ -248,27 +324,38 @@ private:
   }
   template<typename DT>
   void writeAttribute(const NamedMemberForSerialization<DT>& data) {
-    out() << " " << data.name << "=\"";
+    out().write(' ');
+    writeName(data.name);
+    out().write("=\"", 2);
     writeEscaped(data.data);
-    out() << "\"";
+    out().write('"');
   }
   template<typename DT>
   void writeSimpleChild(const NamedMemberForSerialization<DT>& data) {
-    out() << "<" << data.name << ">";
+    out().write('<');
+    writeName(data.name);
+    out().write('>');
     writeEscaped(data.data);
-    out() << "</" << data.name << ">";
+    out().write("</", 2);
+    writeName(data.name);
+    out().write('>');
   }
 
   template<typename DT>
   void writeEscaped(const DT& data) {
-    out() << data;
+    char buf[misc::NumberFormatter::maxLength];
+    out().write(buf, misc::NumberFormatter::format(buf, data) - buf);
   }
 
   void writeEscaped(const bool data);
   void writeEscaped(const std::string& str);
 
+  void writeName(const char* name) {
+    out().write(name, std::strlen(name));
+  }
+
   XmlValueType getValueType() const;
-  std::ostringstream& out();
+  misc::OutputSink& out();
 
 private:
   Impl* impl = nullptr;
@@ -0,0 +1,113 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "sergut/XmlDeserializer.h"
+#include "sergut/xml/detail/RecordedPullParser.h"
+
+namespace sergut {
+
+/**
+ * \brief Resumable deserialization of XML snippets out of partial data
+ *
+ * Like \c XmlDeserializer::deserializeFromSnippet() this deserializes the
+ * element at whose opening tag the \c xml::PullParser is positioned. However,
+ * if the data of the element is not yet complete, it does not throw but
+ * returns \c Status::NeedMoreData. After more data has been appended to the
+ * parser the same function is called again, and it continues with the token
+ * at which it stopped, no save point is needed:
+   \verbatim
+    1 sergut::XmlSnippetDeserializer deser(*pullParser);
+    2 int value;
+    3 while(deser.deserializeFromSnippet("data", value) == sergut::XmlSnippetDeserializer::Status::NeedMoreData) {
+    4   const std::string continuationOfXml = getMoreXml();
+    5   pullParser->appendData(continuationOfXml.c_str(), continuationOfXml.size());
+    6 }
+   \endverbatim
+ *
+ * The tokens of the element are parsed only once, they are recorded until
+ * the element is complete and then the element is deserialized out of the
+ * recorded tokens. Afterwards the parser stands on the first token after the
+ * element and the text following it.
+ *
+ * Invalid XML and data that does not match \c DT still throw a
+ * \c ParsingException. The element is dropped in that case.
+ */
+class XmlSnippetDeserializer
+{
+public:
+  enum class Status {
+    Complete,     ///< the element has been deserialized
+    NeedMoreData  ///< append more data to the parser and call the function again
+  };
+
+  /// \param parser Must be positioned at the opening tag of the first element.
+  XmlSnippetDeserializer(xml::PullParser& parser);
+
+  /**
+   * \brief Deserialize the current element into \c data
+   * \see XmlDeserializer::deserializeFromSnippet()
+   */
+  template<typename DT>
+  Status deserializeFromSnippet(const char* name, DT& data) {
+    if(!recordElement()) {
+      return Status::NeedMoreData;
+    }
+    try {
+      data = XmlDeserializer::deserializeFromSnippet<DT>(name, recordedParser);
+    } catch(...) {
+      recordedParser.clear();
+      throw;
+    }
+    recordedParser.clear();
+    return Status::Complete;
+  }
+
+  /**
+   * \brief Deserialize the nested content of the current element into \c data
+   * \see XmlDeserializer::deserializeNestedFromSnippet()
+   */
+  template<typename DT, XmlValueType xmlValueType = XmlValueType::Child>
+  Status deserializeNestedFromSnippet(const char* outerName, const char* innerName, DT& data) {
+    if(!recordElement()) {
+      return Status::NeedMoreData;
+    }
+    try {
+      data = XmlDeserializer::deserializeNestedFromSnippet<DT, xmlValueType>(outerName, innerName, recordedParser);
+    } catch(...) {
+      recordedParser.clear();
+      throw;
+    }
+    recordedParser.clear();
+    return Status::Complete;
+  }
+
+private:
+  /// Continues recording the current element, returns false if the parser needs more data
+  bool recordElement();
+
+private:
+  xml::PullParser& parser;
+  xml::detail::RecordedPullParser recordedParser;
+};
+
+}
@@ -0,0 +1,77 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace sergut {
+namespace detail {
+
+/**
+ * \brief The quoted and escaped member keys (\c "name":) of one type
+ *
+ * The keys are stored by the position of the member in the serialize
+ * function of the type. An entry is only used if it was created for the same
+ * name, so members that are serialized conditionally or that get their names
+ * at runtime just cause the entry to be replaced.
+ */
+class JsonKeyCache {
+public:
+  /// \brief Returns the cached key for \c name of \c length at \c index or \c nullptr
+  const std::string* find(const std::size_t index, const char* name, const std::size_t length) const {
+    if(index < entries.size() && entries[index].name.size() == length
+       && std::memcmp(entries[index].name.data(), name, length) == 0)
+    {
+      return &entries[index].key;
+    }
+    return nullptr;
+  }
+
+  const std::string& insert(const std::size_t index, const char* name, const std::size_t length, std::string&& key) {
+    if(index >= entries.size()) {
+      entries.resize(index + 1);
+    }
+    entries[index].name.assign(name, length);
+    entries[index].key = std::move(key);
+    return entries[index].key;
+  }
+
+  /// \brief The cache for the members of \c DT, one per thread to avoid locking
+  template<typename DT>
+  static JsonKeyCache& forType() {
+    static thread_local JsonKeyCache cache;
+    return cache;
+  }
+
+private:
+  struct Entry {
+    std::string name;
+    std::string key;
+  };
+  std::vector<Entry> entries;
+};
+
+} // namespace detail
+} // namespace sergut
@@ -0,0 +1,110 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace sergut {
+namespace detail {
+
+/**
+ * \brief Hash index over the members of a rapidjson object
+ *
+ * \c FindMember() compares the name with every member of the object, which
+ * makes binding all members of a wide object quadratic in its width. The index
+ * is built once per object and then finds each member in constant time.
+ * If a name occurs more than once, the first member is found, as with
+ * \c FindMember().
+ *
+ * \tparam Value The rapidjson value type of the object.
+ */
+template<typename Value>
+class JsonMemberIndex {
+public:
+  typedef typename Value::Member Member;
+
+  /// Objects with more members than this are worth indexing
+  static constexpr std::size_t minMemberCount = 16;
+
+  /// Indexes the members of \p object, replacing the previous content
+  void build(Value& object) {
+    std::size_t capacity = 2 * minMemberCount;
+    while(capacity < 2 * object.MemberCount()) {
+      capacity *= 2;
+    }
+    slots.assign(capacity, Slot());
+    mask = capacity - 1;
+    for(auto it = object.MemberBegin(); it != object.MemberEnd(); ++it) {
+      Member& member = *it;
+      const uint32_t hash = computeHash(member.name.GetString(), member.name.GetStringLength());
+      std::size_t pos = hash & mask;
+      while(slots[pos].member != nullptr && !isMember(slots[pos], hash, member.name.GetString(), member.name.GetStringLength())) {
+        pos = (pos + 1) & mask;
+      }
+      if(slots[pos].member == nullptr) {
+        slots[pos] = Slot{hash, &member};
+      }
+    }
+  }
+
+  /// \return The member with the given name or \c nullptr if there is none
+  Member* find(const char* name) const {
+    const std::size_t length = std::strlen(name);
+    const uint32_t hash = computeHash(name, length);
+    for(std::size_t pos = hash & mask; slots[pos].member != nullptr; pos = (pos + 1) & mask) {
+      if(isMember(slots[pos], hash, name, length)) {
+        return slots[pos].member;
+      }
+    }
+    return nullptr;
+  }
+
+private:
+  struct Slot {
+    uint32_t hash;
+    Member* member;
+  };
+
+  static uint32_t computeHash(const char* name, const std::size_t length) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for(std::size_t i = 0; i < length; ++i) {
+      hash = (hash ^ static_cast<unsigned char>(name[i])) * 16777619u;
+    }
+    return hash;
+  }
+
+  static bool isMember(const Slot& slot, const uint32_t hash, const char* name, const std::size_t length) {
+    return slot.hash == hash
+        && slot.member->name.GetStringLength() == length
+        && std::memcmp(slot.member->name.GetString(), name, length) == 0;
+  }
+
+private:
+  std::vector<Slot> slots;
+  std::size_t mask = 0;
+};
+
+} // namespace detail
+} // namespace sergut
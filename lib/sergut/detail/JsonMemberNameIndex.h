@@ -0,0 +1,119 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace sergut {
+namespace detail {
+
+/**
+ * \brief Hash index from the member names of one type to the positions of the
+ *        members in the serialize function of the type
+ *
+ * The \c JsonPullDeserializer builds it once per type and then finds the
+ * member for a JSON member name without comparing the name with all declared
+ * members. If a name is declared more than once, its first position is found.
+ */
+class JsonMemberNameIndex {
+public:
+  /// Returned by \c find() for unknown names
+  static constexpr std::size_t notFound = std::size_t(-1);
+
+  /// \brief Return whether \c finishBuilding() has been called
+  bool isBuilt() const { return built; }
+
+  /// \brief Add the name of the next member in the order of the serialize function
+  void add(const char* name) { names.emplace_back(name); }
+
+  /// \brief Build the hash table out of the added names
+  void finishBuilding() {
+    std::size_t capacity = 8;
+    while(capacity < 2 * names.size()) {
+      capacity *= 2;
+    }
+    slots.assign(capacity, Slot{0, notFound});
+    mask = capacity - 1;
+    for(std::size_t position = 0; position < names.size(); ++position) {
+      const uint32_t hash = computeHash(names[position].data(), names[position].size());
+      std::size_t pos = hash & mask;
+      while(slots[pos].position != notFound && !isMember(slots[pos], hash, names[position].data(), names[position].size())) {
+        pos = (pos + 1) & mask;
+      }
+      if(slots[pos].position == notFound) {
+        slots[pos] = Slot{hash, position};
+      }
+    }
+    built = true;
+  }
+
+  /// \return The position of the member with the given name or \c notFound
+  std::size_t find(const char* name, const std::size_t length) const {
+    const uint32_t hash = computeHash(name, length);
+    for(std::size_t pos = hash & mask; slots[pos].position != notFound; pos = (pos + 1) & mask) {
+      if(isMember(slots[pos], hash, name, length)) {
+        return slots[pos].position;
+      }
+    }
+    return notFound;
+  }
+
+  /// \brief The index for the members of \c DT, one per thread to avoid locking
+  template<typename DT>
+  static JsonMemberNameIndex& forType() {
+    static thread_local JsonMemberNameIndex index;
+    return index;
+  }
+
+private:
+  struct Slot {
+    uint32_t hash;
+    std::size_t position;
+  };
+
+  static uint32_t computeHash(const char* name, const std::size_t length) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for(std::size_t i = 0; i < length; ++i) {
+      hash = (hash ^ static_cast<unsigned char>(name[i])) * 16777619u;
+    }
+    return hash;
+  }
+
+  bool isMember(const Slot& slot, const uint32_t hash, const char* name, const std::size_t length) const {
+    const std::string& memberName = names[slot.position];
+    return slot.hash == hash && memberName.size() == length && std::memcmp(memberName.data(), name, length) == 0;
+  }
+
+private:
+  std::vector<std::string> names;
+  std::vector<Slot> slots;
+  std::size_t mask = 0;
+  bool built = false;
+};
+
+} // namespace detail
+} // namespace sergut
@@ -0,0 +1,53 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cinttypes>
+
+namespace sergut {
+namespace json {
+
+enum class ParseTokenType: uint32_t {
+  InitialState       = static_cast<uint32_t>(-1),
+  OpenObject         = static_cast<uint32_t>(-2),
+  MemberName         = static_cast<uint32_t>(-3),
+  CloseObject        = static_cast<uint32_t>(-4),
+  OpenArray          = static_cast<uint32_t>(-5),
+  CloseArray         = static_cast<uint32_t>(-6),
+  String             = static_cast<uint32_t>(-7),
+  Number             = static_cast<uint32_t>(-8),
+  True               = static_cast<uint32_t>(-9),
+  False              = static_cast<uint32_t>(-10),
+  Null               = static_cast<uint32_t>(-11),
+  CloseDocument      = static_cast<uint32_t>(-12),
+  IncompleteDocument = static_cast<uint32_t>(-13),
+  Error              = static_cast<uint32_t>(-14)
+};
+
+inline
+bool isOk(const ParseTokenType tokenType)
+{
+  return tokenType != ParseTokenType::IncompleteDocument && tokenType != ParseTokenType::Error;
+}
+
+}
+}
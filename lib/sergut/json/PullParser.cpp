@@ -0,0 +1,61 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "sergut/json/PullParser.h"
+
+#include "sergut/json/detail/PullParserUtf8.h"
+#include "sergut/unicode/Utf8Codec.h"
+
+sergut::json::PullParser::~PullParser() { }
+
+std::unique_ptr<sergut::json::PullParser> sergut::json::PullParser::createParser(const sergut::misc::ConstStringRef& data)
+{
+  if(sergut::unicode::Utf8Codec::hasBom(data.begin(), data.end())) {
+    return std::unique_ptr<sergut::json::detail::PullParserUtf8>(new sergut::json::detail::PullParserUtf8(sergut::misc::ConstStringRef(data.begin()+3, data.end())));
+  }
+  return std::unique_ptr<sergut::json::detail::PullParserUtf8>(new sergut::json::detail::PullParserUtf8(data));
+}
+
+std::unique_ptr<sergut::json::PullParser> sergut::json::PullParser::createParser(std::vector<char>&& data)
+{
+  if(sergut::unicode::Utf8Codec::hasBom(data.data(), data.data() + data.size())) {
+    return std::unique_ptr<sergut::json::detail::PullParserUtf8>(new sergut::json::detail::PullParserUtf8(std::move(data), 3));
+  }
+  return std::unique_ptr<sergut::json::detail::PullParserUtf8>(new sergut::json::detail::PullParserUtf8(std::move(data), 0));
+}
+
+std::unique_ptr<sergut::json::PullParser> sergut::json::PullParser::createIndexedParser(const sergut::misc::ConstStringRef& data)
+{
+  std::unique_ptr<sergut::json::detail::PullParserUtf8> parser(
+        sergut::unicode::Utf8Codec::hasBom(data.begin(), data.end())
+        ? new sergut::json::detail::PullParserUtf8(sergut::misc::ConstStringRef(data.begin()+3, data.end()))
+        : new sergut::json::detail::PullParserUtf8(data));
+  parser->buildStructuralIndex();
+  return std::unique_ptr<sergut::json::PullParser>(std::move(parser));
+}
+
+std::unique_ptr<sergut::json::PullParser> sergut::json::PullParser::createIndexedParser(std::vector<char>&& data)
+{
+  const std::size_t offset = sergut::unicode::Utf8Codec::hasBom(data.data(), data.data() + data.size()) ? 3 : 0;
+  std::unique_ptr<sergut::json::detail::PullParserUtf8> parser(new sergut::json::detail::PullParserUtf8(std::move(data), offset));
+  parser->buildStructuralIndex();
+  return std::unique_ptr<sergut::json::PullParser>(std::move(parser));
+}
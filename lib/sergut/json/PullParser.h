@@ -0,0 +1,136 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "sergut/json/ParseTokenType.h"
+#include "sergut/misc/ConstStringRef.h"
+
+#include <memory>
+#include <vector>
+
+namespace sergut {
+namespace json {
+
+/**
+ * \brief The PullParser class implements a simple JSON-Pull-Parser
+ *
+ * It works like its XML counterpart \c sergut::xml::PullParser: instead of
+ * having the JSON events pushed to your code, you are pulling them out using
+ * the \c parseNext() method. The values of the tokens can be accessed using the
+ * \c getCurrentXXX() methods.
+ *
+ * The members of an object are reported as a \c MemberName token that is
+ * followed by the tokens of the member value. No DOM is built, the parser only
+ * keeps the nesting stack of the open objects and arrays.
+ *
+ * The data can be fed incrementally using \c appendData(). If a token is cut
+ * off at the end of the available data, \c parseNext() returns
+ * \c IncompleteDocument without consuming anything; after more data has been
+ * appended the next call of \c parseNext() continues with the same token.
+ * To go back several tokens, e.g. to retry the deserialization of a value that
+ * was only partially available, a save point can be set with
+ * \c setSavePointAtCurrentToken() and returned to using
+ * \c restoreToSavePoint().
+ *
+ * \note A number at the very end of the available data, that is not within
+ *       an object or an array, is reported as complete, as there is no way to
+ *       know whether more digits follow.
+ */
+class PullParser
+{
+public:
+  /**
+   * \brief factory function for \c PullParser
+   *
+   * \param data UTF-8 encoded JSON-data, which is copied into the parser.
+   * \return a \c PullParser.
+   */
+  static std::unique_ptr<PullParser> createParser(const sergut::misc::ConstStringRef& data);
+
+  /**
+   * \brief factory function for \c PullParser for moving the data ownership
+   * into the parser
+   *
+   * \param data UTF-8 encoded JSON-data.
+   * \return a \c PullParser.
+   */
+  static std::unique_ptr<PullParser> createParser(std::vector<char>&& data);
+
+  /**
+   * \brief factory function for a \c PullParser that first builds a
+   * structural index of the complete document
+   *
+   * The index is built in one pass over the data with SIMD instructions, if
+   * available. Afterwards the parser jumps through the index instead of
+   * scanning whitespace and \c skipValue() skips nested values without
+   * parsing their content. This pays off for large documents with many
+   * values that are skipped. If data is appended later, the index is dropped
+   * and the parser continues without it.
+   *
+   * \param data UTF-8 encoded JSON-data, which is copied into the parser.
+   * \return a \c PullParser.
+   */
+  static std::unique_ptr<PullParser> createIndexedParser(const sergut::misc::ConstStringRef& data);
+
+  /**
+   * \brief factory function for a \c PullParser with a structural index
+   * for moving the data ownership into the parser
+   *
+   * \param data UTF-8 encoded JSON-data.
+   * \return a \c PullParser.
+   */
+  static std::unique_ptr<PullParser> createIndexedParser(std::vector<char>&& data);
+
+  virtual ~PullParser();
+
+  /// \brief Parse the next JSON Event
+  virtual ParseTokenType parseNext() = 0;
+  /// \brief Get the last JSON Event
+  virtual ParseTokenType getCurrentTokenType() const = 0;
+  /// \brief Get the decoded name of the current member. It stays valid
+  ///        while the member value is parsed, until the next \c MemberName.
+  virtual sergut::misc::ConstStringRef getCurrentMemberName() const = 0;
+  /// \brief Get the current value. This is either the decoded content of a
+  ///        string or the literal text of a number.
+  virtual sergut::misc::ConstStringRef getCurrentValue() const = 0;
+  /// \brief Get the number of objects and arrays that are currently open
+  virtual std::size_t getCurrentDepth() const = 0;
+  /// \brief Return whether the parser is in a valid state
+  bool isOk() const { return json::isOk(getCurrentTokenType()); }
+  /// \brief Skip the value at the current token including all nested values,
+  ///        afterwards the parser is positioned on the last token of the value.
+  /// \note With a structural index, the content of skipped objects and arrays
+  ///       is only checked for matching brackets.
+  virtual ParseTokenType skipValue() = 0;
+  /// \brief Start parsing a new document out of \c data, reusing the inner
+  ///        buffers of the parser. The save point is discarded.
+  virtual void resetData(const sergut::misc::ConstStringRef& data) = 0;
+  /// \brief Append some data to the inner JSON
+  virtual void appendData(const char* data, const std::size_t size) = 0;
+  /// \brief Set an inner save point right before the current token
+  virtual bool setSavePointAtCurrentToken() = 0;
+  /// \brief Restore the parser to the token where the save point was set
+  virtual bool restoreToSavePoint() = 0;
+};
+
+}
+}
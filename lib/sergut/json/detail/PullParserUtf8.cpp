@@ -0,0 +1,537 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "sergut/json/detail/PullParserUtf8.h"
+
+#include "sergut/misc/EscapeScanner.h"
+#include "sergut/unicode/Utf8Codec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+
+namespace sergut {
+namespace json {
+namespace detail {
+
+static bool isDigit(const char c)
+{
+  return '0' <= c && c <= '9';
+}
+
+static bool isWhitespace(const char c)
+{
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool decodeHexQuad(const char* p, sergut::unicode::Utf32Char& chr)
+{
+  chr = 0;
+  for(const char* end = p + 4; p != end; ++p) {
+    chr <<= 4;
+    if('0' <= *p && *p <= '9') {
+      chr |= *p - '0';
+    } else if('a' <= *p && *p <= 'f') {
+      chr |= *p - 'a' + 10;
+    } else if('A' <= *p && *p <= 'F') {
+      chr |= *p - 'A' + 10;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+PullParserUtf8::PullParserUtf8(const sergut::misc::ConstStringRef& data)
+  : inputData(data.begin(), data.end())
+  , readPointer(inputData.data())
+  , endPointer(inputData.data() + inputData.size())
+  , tokenStart(readPointer)
+{ }
+
+PullParserUtf8::PullParserUtf8(std::vector<char>&& data, const std::size_t offset)
+  : inputData(std::move(data))
+  , readPointer(inputData.data() + offset)
+  , endPointer(inputData.data() + inputData.size())
+  , tokenStart(readPointer)
+{ }
+
+ParseTokenType PullParserUtf8::parseNext()
+{
+  if(currentTokenType == ParseTokenType::CloseDocument || currentTokenType == ParseTokenType::Error) {
+    return currentTokenType;
+  }
+  tokenStart = readPointer;
+  tokenStartExpectation = expectation;
+  if(parseToken() == ParseTokenType::IncompleteDocument) {
+    // Nothing of the cut off token is consumed, so that it is parsed again
+    // after more data has been appended. The container stack is only ever
+    // modified by complete tokens.
+    readPointer = tokenStart;
+    expectation = tokenStartExpectation;
+  }
+  return currentTokenType;
+}
+
+ParseTokenType PullParserUtf8::skipValue()
+{
+  if(currentTokenType != ParseTokenType::OpenObject && currentTokenType != ParseTokenType::OpenArray) {
+    return currentTokenType;
+  }
+  if(structuralIndex) {
+    // Count the brackets in the index up to the one that closes the current
+    // container. The brackets inside of strings are not in the index.
+    const std::vector<uint32_t>& positions = structuralIndex->getPositions();
+    const char* const data = inputData.data();
+    std::size_t cursor = structuralIndex->findNext(static_cast<uint32_t>(readPointer - data), structuralCursor);
+    std::size_t depth = 1;
+    for(; cursor + 1 < positions.size(); ++cursor) {
+      const char c = data[positions[cursor]];
+      if(c == '{' || c == '[') {
+        ++depth;
+      } else if((c == '}' || c == ']') && --depth == 0) {
+        break;
+      }
+    }
+    if(depth == 0) {
+      structuralCursor = cursor;
+      readPointer = data + positions[cursor];
+      tokenStart = readPointer;
+      tokenStartExpectation = Expectation::Separator;
+      return *readPointer == '}' ? closeContainer('{', ParseTokenType::CloseObject)
+                                 : closeContainer('[', ParseTokenType::CloseArray);
+    }
+    // the container is not closed within the data, which is reported by
+    // parsing the tokens one by one
+  }
+  const std::size_t depth = containerStack.size();
+  while(json::isOk(parseNext()) && containerStack.size() >= depth) { }
+  return currentTokenType;
+}
+
+void PullParserUtf8::buildStructuralIndex()
+{
+  if(!structuralIndex) {
+    structuralIndex.reset(new StructuralIndex);
+  }
+  if(!structuralIndex->build(inputData.data(), inputData.size())) {
+    structuralIndex.reset();
+  }
+  structuralCursor = 0;
+}
+
+void PullParserUtf8::resetData(const sergut::misc::ConstStringRef& data)
+{
+  inputData.assign(data.begin(), data.end());
+  readPointer = inputData.data();
+  endPointer = inputData.data() + inputData.size();
+  tokenStart = readPointer;
+  containerStack.clear();
+  expectation = Expectation::Value;
+  tokenStartExpectation = Expectation::Value;
+  currentTokenType = ParseTokenType::InitialState;
+  currentMemberName = sergut::misc::ConstStringRef();
+  currentValue = sergut::misc::ConstStringRef();
+  savePoint.isSet = false;
+  if(structuralIndex) {
+    buildStructuralIndex();
+  }
+}
+
+void PullParserUtf8::appendData(const char* data, const std::size_t size)
+{
+  // the index does not cover the new data
+  structuralIndex.reset();
+  compressInnerData();
+  const char* const oldBegin = inputData.data();
+  const char* const oldEnd = oldBegin + inputData.size();
+  inputData.insert(inputData.end(), data, data + size);
+  relocatePointersToInput(oldBegin, oldEnd, 0);
+}
+
+bool PullParserUtf8::setSavePointAtCurrentToken()
+{
+  if(currentTokenType == ParseTokenType::InitialState
+     || currentTokenType == ParseTokenType::CloseDocument
+     || !isOk())
+  {
+    // we cannot set a save point if we are not on a token
+    return false;
+  }
+  savePoint.isSet = true;
+  savePoint.readOffset = static_cast<std::size_t>(tokenStart - inputData.data());
+  savePoint.expectation = tokenStartExpectation;
+  savePoint.containerStack = containerStack;
+  // the stack has to be the one from before the current token
+  switch(currentTokenType) {
+  case ParseTokenType::OpenObject:
+  case ParseTokenType::OpenArray:
+    savePoint.containerStack.pop_back();
+    break;
+  case ParseTokenType::CloseObject:
+    savePoint.containerStack.push_back('{');
+    break;
+  case ParseTokenType::CloseArray:
+    savePoint.containerStack.push_back('[');
+    break;
+  default:
+    break;
+  }
+  return true;
+}
+
+bool PullParserUtf8::restoreToSavePoint()
+{
+  if(!savePoint.isSet) {
+    currentTokenType = ParseTokenType::Error;
+    return false;
+  }
+  readPointer = inputData.data() + savePoint.readOffset;
+  expectation = savePoint.expectation;
+  containerStack = savePoint.containerStack;
+  currentTokenType = ParseTokenType::InitialState;
+  return json::isOk(parseNext());
+}
+
+void PullParserUtf8::compressInnerData()
+{
+  // Keep everything that is still referenced: the current token, which is
+  // parsed again if it is incomplete, the save point and the current member
+  // name and value, if they are not decoded into the inner buffers.
+  const char* const begin = inputData.data();
+  const char* const end = begin + inputData.size();
+  const char* keepFrom = tokenStart;
+  if(savePoint.isSet) {
+    keepFrom = std::min(keepFrom, begin + savePoint.readOffset);
+  }
+  for(const sergut::misc::ConstStringRef* ref: { &currentMemberName, &currentValue }) {
+    if(begin <= ref->begin() && ref->begin() <= end) {
+      keepFrom = std::min(keepFrom, ref->begin());
+    }
+  }
+  const std::size_t removedPrefix = static_cast<std::size_t>(keepFrom - begin);
+  // Only compress if at least half of the data can be dropped, otherwise
+  // appending many small chunks to a long incomplete token becomes quadratic
+  if(removedPrefix == 0 || removedPrefix < inputData.size() / 2) {
+    return;
+  }
+  inputData.erase(inputData.begin(), inputData.begin() + static_cast<std::ptrdiff_t>(removedPrefix));
+  if(savePoint.isSet) {
+    savePoint.readOffset -= removedPrefix;
+  }
+  relocatePointersToInput(begin, end, removedPrefix);
+}
+
+void PullParserUtf8::relocatePointersToInput(const char* oldBegin, const char* oldEnd, const std::size_t removedPrefix)
+{
+  const char* const newBegin = inputData.data();
+  const auto relocate = [&](const char* p) { return newBegin + ((p - oldBegin) - static_cast<std::ptrdiff_t>(removedPrefix)); };
+  readPointer = relocate(readPointer);
+  tokenStart = relocate(tokenStart);
+  endPointer = newBegin + inputData.size();
+  for(sergut::misc::ConstStringRef* ref: { &currentMemberName, &currentValue }) {
+    if(oldBegin <= ref->begin() && ref->begin() <= oldEnd) {
+      *ref = sergut::misc::ConstStringRef(relocate(ref->begin()), relocate(ref->end()));
+    }
+  }
+}
+
+ParseTokenType PullParserUtf8::parseToken()
+{
+  if(!skipWhitespace()) {
+    if(expectation == Expectation::Separator && containerStack.empty()) {
+      return setToken(ParseTokenType::CloseDocument);
+    }
+    return setToken(ParseTokenType::IncompleteDocument);
+  }
+  switch(expectation) {
+  case Expectation::Value:
+    return parseValue();
+  case Expectation::MemberOrClose:
+    if(*readPointer == '}') {
+      return closeContainer('{', ParseTokenType::CloseObject);
+    }
+    return parseMemberName();
+  case Expectation::ValueOrClose:
+    if(*readPointer == ']') {
+      return closeContainer('[', ParseTokenType::CloseArray);
+    }
+    return parseValue();
+  case Expectation::Separator:
+    break;
+  }
+  // only whitespace may follow the outermost value
+  if(containerStack.empty()) {
+    return setToken(ParseTokenType::Error);
+  }
+  switch(*readPointer) {
+  case ',':
+    ++readPointer;
+    if(!skipWhitespace()) {
+      return setToken(ParseTokenType::IncompleteDocument);
+    }
+    return containerStack.back() == '{' ? parseMemberName() : parseValue();
+  case '}':
+    return closeContainer('{', ParseTokenType::CloseObject);
+  case ']':
+    return closeContainer('[', ParseTokenType::CloseArray);
+  default:
+    return setToken(ParseTokenType::Error);
+  }
+}
+
+bool PullParserUtf8::skipWhitespace()
+{
+  if(structuralIndex && readPointer != endPointer && isWhitespace(*readPointer)) {
+    // everything up to the next structural character is whitespace
+    const char* const data = inputData.data();
+    structuralCursor = structuralIndex->findNext(static_cast<uint32_t>(readPointer - data), structuralCursor);
+    readPointer = data + structuralIndex->getPositions()[structuralCursor];
+    return readPointer != endPointer;
+  }
+  for(; readPointer != endPointer; ++readPointer) {
+    switch(*readPointer) {
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\r':
+      break;
+    default:
+      return true;
+    }
+  }
+  return false;
+}
+
+ParseTokenType PullParserUtf8::parseValue()
+{
+  switch(*readPointer) {
+  case '{':
+    return openContainer('{', ParseTokenType::OpenObject, Expectation::MemberOrClose);
+  case '[':
+    return openContainer('[', ParseTokenType::OpenArray, Expectation::ValueOrClose);
+  case '"': {
+    ++readPointer;
+    const ParseTokenType tokenType = parseString(currentValue, valueBuffer);
+    if(tokenType == ParseTokenType::String) {
+      expectation = Expectation::Separator;
+    }
+    return setToken(tokenType);
+  }
+  case 't':
+    return parseLiteral("true", 4, ParseTokenType::True);
+  case 'f':
+    return parseLiteral("false", 5, ParseTokenType::False);
+  case 'n':
+    return parseLiteral("null", 4, ParseTokenType::Null);
+  case '-':
+  case '0': case '1': case '2': case '3': case '4':
+  case '5': case '6': case '7': case '8': case '9':
+    return parseNumber();
+  default:
+    return setToken(ParseTokenType::Error);
+  }
+}
+
+ParseTokenType PullParserUtf8::parseMemberName()
+{
+  if(*readPointer != '"') {
+    return setToken(ParseTokenType::Error);
+  }
+  ++readPointer;
+  const ParseTokenType tokenType = parseString(currentMemberName, memberNameBuffer);
+  if(tokenType != ParseTokenType::String) {
+    return setToken(tokenType);
+  }
+  if(!skipWhitespace()) {
+    return setToken(ParseTokenType::IncompleteDocument);
+  }
+  if(*readPointer != ':') {
+    return setToken(ParseTokenType::Error);
+  }
+  ++readPointer;
+  expectation = Expectation::Value;
+  return setToken(ParseTokenType::MemberName);
+}
+
+ParseTokenType PullParserUtf8::parseString(sergut::misc::ConstStringRef& dest, std::string& decodingBuffer)
+{
+  // readPointer is positioned right after the opening quote
+  const char* pos = sergut::misc::EscapeScanner::findJsonSpecial(readPointer, endPointer);
+  if(pos == endPointer) {
+    return ParseTokenType::IncompleteDocument;
+  }
+  if(*pos == '"') {
+    // no escape sequences: reference the string in the input
+    dest = sergut::misc::ConstStringRef(readPointer, pos);
+    readPointer = pos + 1;
+    return ParseTokenType::String;
+  }
+  decodingBuffer.assign(readPointer, pos);
+  while(*pos != '"') {
+    if(*pos != '\\') {
+      // unescaped control character
+      return ParseTokenType::Error;
+    }
+    if(endPointer - pos < 2) {
+      return ParseTokenType::IncompleteDocument;
+    }
+    switch(pos[1]) {
+    case '"':  decodingBuffer.push_back('"');  break;
+    case '\\': decodingBuffer.push_back('\\'); break;
+    case '/':  decodingBuffer.push_back('/');  break;
+    case 'b':  decodingBuffer.push_back('\b'); break;
+    case 'f':  decodingBuffer.push_back('\f'); break;
+    case 'n':  decodingBuffer.push_back('\n'); break;
+    case 'r':  decodingBuffer.push_back('\r'); break;
+    case 't':  decodingBuffer.push_back('\t'); break;
+    case 'u': {
+      if(endPointer - pos < 6) {
+        return ParseTokenType::IncompleteDocument;
+      }
+      sergut::unicode::Utf32Char chr;
+      if(!decodeHexQuad(pos + 2, chr)) {
+        return ParseTokenType::Error;
+      }
+      if(0xD800 <= chr && chr <= 0xDBFF) {
+        // a high surrogate has to be followed by an escaped low surrogate
+        if(endPointer - pos < 12) {
+          return ParseTokenType::IncompleteDocument;
+        }
+        sergut::unicode::Utf32Char lowSurrogate;
+        if(pos[6] != '\\' || pos[7] != 'u' || !decodeHexQuad(pos + 8, lowSurrogate)
+           || lowSurrogate < 0xDC00 || lowSurrogate > 0xDFFF)
+        {
+          return ParseTokenType::Error;
+        }
+        chr = 0x10000 + ((chr - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+        pos += 6;
+      }
+      if(sergut::unicode::isError(sergut::unicode::Utf8Codec::appendChar(decodingBuffer, chr))) {
+        return ParseTokenType::Error;
+      }
+      pos += 4;
+      break;
+    }
+    default:
+      return ParseTokenType::Error;
+    }
+    pos += 2;
+    const char* const next = sergut::misc::EscapeScanner::findJsonSpecial(pos, endPointer);
+    if(next == endPointer) {
+      return ParseTokenType::IncompleteDocument;
+    }
+    decodingBuffer.append(pos, next);
+    pos = next;
+  }
+  dest = sergut::misc::ConstStringRef(decodingBuffer.data(), decodingBuffer.data() + decodingBuffer.size());
+  readPointer = pos + 1;
+  return ParseTokenType::String;
+}
+
+ParseTokenType PullParserUtf8::parseNumber()
+{
+  // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+  const char* pos = readPointer;
+  if(*pos == '-') {
+    ++pos;
+  }
+  if(pos == endPointer) {
+    return setToken(ParseTokenType::IncompleteDocument);
+  }
+  if(*pos == '0') {
+    ++pos;
+  } else if(isDigit(*pos)) {
+    while(pos != endPointer && isDigit(*pos)) { ++pos; }
+  } else {
+    return setToken(ParseTokenType::Error);
+  }
+  if(pos != endPointer && *pos == '.') {
+    ++pos;
+    if(pos == endPointer) {
+      return setToken(ParseTokenType::IncompleteDocument);
+    }
+    if(!isDigit(*pos)) {
+      return setToken(ParseTokenType::Error);
+    }
+    while(pos != endPointer && isDigit(*pos)) { ++pos; }
+  }
+  if(pos != endPointer && (*pos == 'e' || *pos == 'E')) {
+    ++pos;
+    if(pos != endPointer && (*pos == '+' || *pos == '-')) {
+      ++pos;
+    }
+    if(pos == endPointer) {
+      return setToken(ParseTokenType::IncompleteDocument);
+    }
+    if(!isDigit(*pos)) {
+      return setToken(ParseTokenType::Error);
+    }
+    while(pos != endPointer && isDigit(*pos)) { ++pos; }
+  }
+  if(pos == endPointer && !containerStack.empty()) {
+    // inside of a container the number might continue in data that is not there yet
+    return setToken(ParseTokenType::IncompleteDocument);
+  }
+  currentValue = sergut::misc::ConstStringRef(readPointer, pos);
+  readPointer = pos;
+  expectation = Expectation::Separator;
+  return setToken(ParseTokenType::Number);
+}
+
+ParseTokenType PullParserUtf8::parseLiteral(const char* literal, const std::size_t literalSize, const ParseTokenType tokenType)
+{
+  const std::size_t available = static_cast<std::size_t>(endPointer - readPointer);
+  if(available < literalSize) {
+    return setToken(std::memcmp(readPointer, literal, available) == 0
+                    ? ParseTokenType::IncompleteDocument : ParseTokenType::Error);
+  }
+  if(std::memcmp(readPointer, literal, literalSize) != 0) {
+    return setToken(ParseTokenType::Error);
+  }
+  currentValue = sergut::misc::ConstStringRef(readPointer, readPointer + literalSize);
+  readPointer += literalSize;
+  expectation = Expectation::Separator;
+  return setToken(tokenType);
+}
+
+ParseTokenType PullParserUtf8::openContainer(const char openingChar, const ParseTokenType tokenType, const Expectation nextExpectation)
+{
+  containerStack.push_back(openingChar);
+  ++readPointer;
+  expectation = nextExpectation;
+  return setToken(tokenType);
+}
+
+ParseTokenType PullParserUtf8::closeContainer(const char openingChar, const ParseTokenType tokenType)
+{
+  if(containerStack.empty() || containerStack.back() != openingChar) {
+    return setToken(ParseTokenType::Error);
+  }
+  containerStack.pop_back();
+  ++readPointer;
+  expectation = Expectation::Separator;
+  return setToken(tokenType);
+}
+
+}
+}
+}
@@ -0,0 +1,121 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "sergut/json/PullParser.h"
+#include "sergut/json/detail/StructuralIndex.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sergut {
+namespace json {
+namespace detail {
+
+/**
+ * \brief The PullParserUtf8 class implements the JSON-Pull-Parser for UTF-8
+ *        encoded input
+ *
+ * Strings without escape sequences are returned as references into the input
+ * buffer, only strings that contain escape sequences are decoded into an inner
+ * buffer. Numbers are returned as their literal text and converted by the
+ * caller.
+ *
+ * Optionally the parser walks a \c StructuralIndex of the data, which makes
+ * it the second stage of a simdjson-like two stage parser.
+ */
+class PullParserUtf8: public PullParser
+{
+public:
+  PullParserUtf8(const sergut::misc::ConstStringRef& data);
+  PullParserUtf8(std::vector<char>&& data, const std::size_t offset);
+
+  ParseTokenType parseNext() override;
+  ParseTokenType getCurrentTokenType() const override { return currentTokenType; }
+  sergut::misc::ConstStringRef getCurrentMemberName() const override { return currentMemberName; }
+  sergut::misc::ConstStringRef getCurrentValue() const override { return currentValue; }
+  std::size_t getCurrentDepth() const override { return containerStack.size(); }
+  ParseTokenType skipValue() override;
+  void resetData(const sergut::misc::ConstStringRef& data) override;
+  void appendData(const char* data, const std::size_t size) override;
+  bool setSavePointAtCurrentToken() override;
+  bool restoreToSavePoint() override;
+
+  /// \brief Build the structural index of the data, which the parser uses
+  ///        until data is appended
+  void buildStructuralIndex();
+
+private:
+  /// What the parser expects after the current token
+  enum class Expectation: uint8_t {
+    Value,          ///< a value, e.g. at the start of the document or after a member name
+    MemberOrClose,  ///< the first member of an object or '}'
+    ValueOrClose,   ///< the first element of an array or ']'
+    Separator       ///< ',' or the closing bracket of the current container, or the end of the document
+  };
+
+  /// The state right before the current token, re-parsing from there yields the current token again
+  struct SavePoint {
+    bool isSet = false;
+    std::size_t readOffset = 0;
+    Expectation expectation = Expectation::Value;
+    std::vector<char> containerStack;
+  };
+
+  ParseTokenType parseToken();
+  bool skipWhitespace();
+  ParseTokenType parseValue();
+  ParseTokenType parseMemberName();
+  ParseTokenType parseString(sergut::misc::ConstStringRef& dest, std::string& decodingBuffer);
+  ParseTokenType parseNumber();
+  ParseTokenType parseLiteral(const char* literal, const std::size_t literalSize, const ParseTokenType tokenType);
+  ParseTokenType openContainer(const char openingChar, const ParseTokenType tokenType, const Expectation nextExpectation);
+  ParseTokenType closeContainer(const char openingChar, const ParseTokenType tokenType);
+  ParseTokenType setToken(const ParseTokenType tokenType) { return currentTokenType = tokenType; }
+  void compressInnerData();
+  void relocatePointersToInput(const char* oldBegin, const char* oldEnd, const std::size_t removedPrefix);
+
+private:
+  std::vector<char> inputData;
+  const char* readPointer;
+  const char* endPointer;
+  /// the read position before the current token was parsed
+  const char* tokenStart;
+  std::vector<char> containerStack;
+  Expectation expectation = Expectation::Value;
+  /// the expectation before the current token was parsed
+  Expectation tokenStartExpectation = Expectation::Value;
+  SavePoint savePoint;
+  std::unique_ptr<StructuralIndex> structuralIndex;
+  /// the index into the positions of the structural index, where the search for the next token starts
+  std::size_t structuralCursor = 0;
+  ParseTokenType currentTokenType = ParseTokenType::InitialState;
+  sergut::misc::ConstStringRef currentMemberName;
+  sergut::misc::ConstStringRef currentValue;
+  std::string memberNameBuffer;
+  std::string valueBuffer;
+};
+
+}
+}
+}
@@ -0,0 +1,303 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "sergut/json/detail/StructuralIndex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SERGUT_STRUCTURAL_INDEX_X86
+#include <immintrin.h>
+#endif
+
+namespace sergut {
+namespace json {
+namespace detail {
+
+namespace {
+
+const std::size_t blockSize = 64;
+
+/// One bit per byte of a block of 64 bytes
+struct BlockMasks {
+  uint64_t backslash;
+  uint64_t quote;
+  uint64_t op;
+  uint64_t whitespace;
+};
+
+/// The state that is carried from one block to the next
+struct BlockCarry {
+  bool nextIsEscaped = false;
+  uint64_t inString = 0;     ///< all bits set, if the previous block ended inside of a string
+  uint64_t scalar = 0;       ///< 1, if the previous block ended with a byte of a number or literal
+};
+
+enum ByteClass: uint8_t {
+  OtherByte = 0,
+  BackslashByte = 1,
+  QuoteByte = 2,
+  OperatorByte = 3,
+  WhitespaceByte = 4
+};
+
+struct ByteClassTable {
+  ByteClassTable() {
+    std::memset(table, OtherByte, sizeof(table));
+    table[static_cast<unsigned char>('\\')] = BackslashByte;
+    table[static_cast<unsigned char>('"')] = QuoteByte;
+    for(const char c: { '{', '}', '[', ']', ':', ',' }) {
+      table[static_cast<unsigned char>(c)] = OperatorByte;
+    }
+    for(const char c: { ' ', '\t', '\n', '\r' }) {
+      table[static_cast<unsigned char>(c)] = WhitespaceByte;
+    }
+  }
+
+  uint8_t table[256];
+};
+
+const ByteClassTable byteClasses;
+
+BlockMasks classifyScalar(const char* block)
+{
+  uint64_t masks[5] = { 0, 0, 0, 0, 0 };
+  for(std::size_t i = 0; i < blockSize; ++i) {
+    masks[byteClasses.table[static_cast<unsigned char>(block[i])]] |= uint64_t(1) << i;
+  }
+  return BlockMasks{ masks[BackslashByte], masks[QuoteByte], masks[OperatorByte], masks[WhitespaceByte] };
+}
+
+#ifdef SERGUT_STRUCTURAL_INDEX_X86
+__attribute__((target("sse2")))
+inline __m128i equalSse2(const __m128i b, const char c) { return _mm_cmpeq_epi8(b, _mm_set1_epi8(c)); }
+
+__attribute__((target("sse2")))
+inline uint64_t bitsSse2(const __m128i m) { return static_cast<uint16_t>(_mm_movemask_epi8(m)); }
+
+__attribute__((target("sse2")))
+BlockMasks classifySse2(const char* block)
+{
+  BlockMasks masks{ 0, 0, 0, 0 };
+  for(std::size_t i = 0; i < blockSize; i += 16) {
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+    const __m128i op = _mm_or_si128(_mm_or_si128(_mm_or_si128(equalSse2(b, '{'), equalSse2(b, '}')),
+                                                 _mm_or_si128(equalSse2(b, '['), equalSse2(b, ']'))),
+                                    _mm_or_si128(equalSse2(b, ':'), equalSse2(b, ',')));
+    const __m128i ws = _mm_or_si128(_mm_or_si128(equalSse2(b, ' '), equalSse2(b, '\t')),
+                                    _mm_or_si128(equalSse2(b, '\n'), equalSse2(b, '\r')));
+    masks.backslash |= bitsSse2(equalSse2(b, '\\')) << i;
+    masks.quote |= bitsSse2(equalSse2(b, '"')) << i;
+    masks.op |= bitsSse2(op) << i;
+    masks.whitespace |= bitsSse2(ws) << i;
+  }
+  return masks;
+}
+
+__attribute__((target("avx2")))
+inline __m256i equalAvx2(const __m256i b, const char c) { return _mm256_cmpeq_epi8(b, _mm256_set1_epi8(c)); }
+
+__attribute__((target("avx2")))
+inline uint64_t bitsAvx2(const __m256i m) { return static_cast<uint32_t>(_mm256_movemask_epi8(m)); }
+
+__attribute__((target("avx2")))
+BlockMasks classifyAvx2(const char* block)
+{
+  BlockMasks masks{ 0, 0, 0, 0 };
+  for(std::size_t i = 0; i < blockSize; i += 32) {
+    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+    const __m256i op = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(equalAvx2(b, '{'), equalAvx2(b, '}')),
+                                                       _mm256_or_si256(equalAvx2(b, '['), equalAvx2(b, ']'))),
+                                       _mm256_or_si256(equalAvx2(b, ':'), equalAvx2(b, ',')));
+    const __m256i ws = _mm256_or_si256(_mm256_or_si256(equalAvx2(b, ' '), equalAvx2(b, '\t')),
+                                       _mm256_or_si256(equalAvx2(b, '\n'), equalAvx2(b, '\r')));
+    masks.backslash |= bitsAvx2(equalAvx2(b, '\\')) << i;
+    masks.quote |= bitsAvx2(equalAvx2(b, '"')) << i;
+    masks.op |= bitsAvx2(op) << i;
+    masks.whitespace |= bitsAvx2(ws) << i;
+  }
+  return masks;
+}
+#endif
+
+/// The bytes that are escaped by a backslash. Backslashes are rare, so they are visited one by one.
+inline uint64_t escapedBytes(uint64_t backslash, BlockCarry& carry)
+{
+  uint64_t escaped = carry.nextIsEscaped ? 1 : 0;
+  carry.nextIsEscaped = false;
+  // an escaped backslash does not escape anything
+  backslash &= ~escaped;
+  while(backslash != 0) {
+    const unsigned pos = static_cast<unsigned>(__builtin_ctzll(backslash));
+    if(pos == blockSize - 1) {
+      carry.nextIsEscaped = true;
+      break;
+    }
+    escaped |= uint64_t(2) << pos;
+    backslash &= ~(uint64_t(3) << pos);
+  }
+  return escaped;
+}
+
+/// Bit i of the result is the parity of the bits 0..i of \c x
+inline uint64_t prefixXor(uint64_t x)
+{
+  x ^= x << 1;
+  x ^= x << 2;
+  x ^= x << 4;
+  x ^= x << 8;
+  x ^= x << 16;
+  x ^= x << 32;
+  return x;
+}
+
+/// Computes the structural bits of a block out of its masks
+inline uint64_t structuralBits(const BlockMasks& masks, BlockCarry& carry)
+{
+  const uint64_t quote = masks.quote & ~escapedBytes(masks.backslash, carry);
+  // set from the opening quote up to the byte before the closing quote
+  const uint64_t inString = prefixXor(quote) ^ carry.inString;
+  carry.inString = static_cast<uint64_t>(static_cast<int64_t>(inString) >> 63);
+  const uint64_t scalar = ~(masks.op | masks.whitespace | quote | inString);
+  const uint64_t scalarStart = scalar & ~((scalar << 1) | carry.scalar);
+  carry.scalar = scalar >> 63;
+  return (masks.op & ~inString) | (quote & inString) | scalarStart;
+}
+
+template<typename Classify>
+inline void indexBlocks(const char* data, const std::size_t size, std::vector<uint32_t>& positions, Classify classify)
+{
+  BlockCarry carry;
+  const auto appendPositions = [&positions](uint64_t structurals, const uint32_t blockStart) {
+    while(structurals != 0) {
+      positions.push_back(blockStart + static_cast<uint32_t>(__builtin_ctzll(structurals)));
+      structurals &= structurals - 1;
+    }
+  };
+  std::size_t blockStart = 0;
+  for(; blockStart + blockSize <= size; blockStart += blockSize) {
+    appendPositions(structuralBits(classify(data + blockStart), carry), static_cast<uint32_t>(blockStart));
+  }
+  if(blockStart < size) {
+    // the last block is padded with whitespace
+    char lastBlock[blockSize];
+    std::memset(lastBlock, ' ', blockSize);
+    std::memcpy(lastBlock, data + blockStart, size - blockStart);
+    appendPositions(structuralBits(classify(lastBlock), carry), static_cast<uint32_t>(blockStart));
+  }
+}
+
+void indexScalar(const char* data, const std::size_t size, std::vector<uint32_t>& positions)
+{
+  indexBlocks(data, size, positions, classifyScalar);
+}
+
+#ifdef SERGUT_STRUCTURAL_INDEX_X86
+__attribute__((target("sse2")))
+void indexSse2(const char* data, const std::size_t size, std::vector<uint32_t>& positions)
+{
+  indexBlocks(data, size, positions, classifySse2);
+}
+
+__attribute__((target("avx2")))
+void indexAvx2(const char* data, const std::size_t size, std::vector<uint32_t>& positions)
+{
+  indexBlocks(data, size, positions, classifyAvx2);
+}
+#endif
+
+}
+
+bool StructuralIndex::isSupported(const Implementation implementation)
+{
+#ifdef SERGUT_STRUCTURAL_INDEX_X86
+  __builtin_cpu_init();
+#endif
+  switch(implementation) {
+  case Implementation::Scalar:
+    return true;
+#ifdef SERGUT_STRUCTURAL_INDEX_X86
+  case Implementation::Sse2:
+    return __builtin_cpu_supports("sse2");
+  case Implementation::Avx2:
+    return __builtin_cpu_supports("avx2");
+#else
+  case Implementation::Sse2:
+  case Implementation::Avx2:
+    return false;
+#endif
+  }
+  return false;
+}
+
+StructuralIndex::Implementation StructuralIndex::bestImplementation()
+{
+  static const Implementation best =
+      isSupported(Implementation::Avx2) ? Implementation::Avx2
+                                        : isSupported(Implementation::Sse2) ? Implementation::Sse2
+                                                                           : Implementation::Scalar;
+  return best;
+}
+
+bool StructuralIndex::build(const char* data, const std::size_t size, const Implementation implementation)
+{
+  positions.clear();
+  if(size >= std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+  // most documents have a structural character every few bytes
+  positions.reserve(size / 4 + 1);
+  switch(implementation) {
+#ifdef SERGUT_STRUCTURAL_INDEX_X86
+  case Implementation::Avx2:
+    indexAvx2(data, size, positions);
+    break;
+  case Implementation::Sse2:
+    indexSse2(data, size, positions);
+    break;
+#endif
+  default:
+    indexScalar(data, size, positions);
+    break;
+  }
+  positions.push_back(static_cast<uint32_t>(size));
+  return true;
+}
+
+std::size_t StructuralIndex::findNext(const uint32_t offset, std::size_t hint) const
+{
+  if(hint > 0 && positions[hint - 1] >= offset) {
+    // the parser went backwards, e.g. to a save point
+    return static_cast<std::size_t>(std::lower_bound(positions.begin(), positions.begin() + static_cast<std::ptrdiff_t>(hint), offset)
+                                    - positions.begin());
+  }
+  // the last position is the size of the document, thus the loop terminates
+  while(positions[hint] < offset) {
+    ++hint;
+  }
+  return hint;
+}
+
+}
+}
+}
@@ -0,0 +1,97 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sergut {
+namespace json {
+namespace detail {
+
+/**
+ * \brief The positions of the structural characters of a JSON document
+ *
+ * This is the first stage of a two stage parser in the style of simdjson:
+ * the document is classified in blocks of 64 bytes, which results in one bit
+ * per byte for quotes, backslashes, whitespace and the operators
+ * '{', '}', '[', ']', ':' and ','. Out of these masks the escaped quotes and
+ * the bytes inside of strings are computed without branching per byte.
+ *
+ * The index contains the positions of the operators outside of strings, of
+ * the opening quotes of strings and of the first byte of every other value
+ * (numbers and literals). Thus every byte outside of strings, that is not
+ * whitespace, is either in the index or part of the value that starts at the
+ * preceding index position. The last position is the size of the document.
+ *
+ * The second stage, the \c PullParserUtf8, jumps from one position to the next
+ * instead of scanning whitespace and skips nested values by counting brackets
+ * in the index.
+ *
+ * Depending on the CPU the blocks are classified with AVX2, with SSE2 or
+ * with a scalar fallback. The implementation is selected at runtime.
+ */
+class StructuralIndex
+{
+public:
+  enum class Implementation {
+    Scalar,
+    Sse2,
+    Avx2
+  };
+
+  /// \brief Return whether \c implementation can be used on this CPU
+  static bool isSupported(const Implementation implementation);
+  /// \brief Return the fastest implementation that can be used on this CPU
+  static Implementation bestImplementation();
+
+  /**
+   * \brief Build the index of \c data with the best implementation
+   * \return false, if the data is too large to be indexed (4GiB)
+   */
+  bool build(const char* data, const std::size_t size) { return build(data, size, bestImplementation()); }
+
+  /**
+   * \brief Build the index of \c data
+   * \param implementation must be supported on this CPU.
+   * \return false, if the data is too large to be indexed (4GiB)
+   */
+  bool build(const char* data, const std::size_t size, const Implementation implementation);
+
+  /// \brief The positions of the structural characters, followed by the size of the document
+  const std::vector<uint32_t>& getPositions() const { return positions; }
+
+  /**
+   * \brief Find the first position that is not before \c offset
+   * \param hint the result of a previous call, searching starts there
+   * \return the index into \c getPositions()
+   */
+  std::size_t findNext(const uint32_t offset, std::size_t hint) const;
+
+private:
+  std::vector<uint32_t> positions;
+};
+
+}
+}
+}
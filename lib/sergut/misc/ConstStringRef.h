@@ -61,6 +61,10 @@ public:
   }
 
   void addOffset(const std::ptrdiff_t offset) {
+    if(beginPtr == nullptr) {
+      // a null reference does not point into any buffer that could have moved
+      return;
+    }
     beginPtr += offset;
     endPtr   += offset;
   }
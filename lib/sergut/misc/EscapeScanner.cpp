@@ -0,0 +1,151 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "sergut/misc/EscapeScanner.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace sergut {
+namespace misc {
+namespace EscapeScanner {
+
+namespace {
+
+/// Lookup table with the bytes that have to be escaped
+struct SpecialByteTable {
+  SpecialByteTable(const char* specialChars, const bool controlChars, const bool nonAsciiChars = false,
+                   const char* allowedControlChars = "") {
+    for(int c = 0; c < 256; ++c) {
+      table[c] = (controlChars && c < 0x20) || (nonAsciiChars && c > 0x7f);
+    }
+    for(; *specialChars != '\0'; ++specialChars) {
+      table[static_cast<unsigned char>(*specialChars)] = true;
+    }
+    for(; *allowedControlChars != '\0'; ++allowedControlChars) {
+      table[static_cast<unsigned char>(*allowedControlChars)] = false;
+    }
+  }
+
+  const char* find(const char* begin, const char* end) const {
+    while(begin != end && !table[static_cast<unsigned char>(*begin)]) {
+      ++begin;
+    }
+    return begin;
+  }
+
+  const char* find(const char* begin, const char* end, const char extraChar) const {
+    while(begin != end && !table[static_cast<unsigned char>(*begin)] && *begin != extraChar) {
+      ++begin;
+    }
+    return begin;
+  }
+
+  bool table[256];
+};
+
+const SpecialByteTable jsonSpecialBytes("\"\\", true);
+const SpecialByteTable xmlSpecialBytes("\"&'<>", false);
+const SpecialByteTable xmlTextSpecialBytes("<&", true, true, "\t\n\r");
+
+#if defined(__AVX2__)
+typedef __m256i Block;
+inline Block loadBlock(const char* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+inline Block splat(const char c) { return _mm256_set1_epi8(c); }
+inline Block equal(const Block a, const Block b) { return _mm256_cmpeq_epi8(a, b); }
+inline Block either(const Block a, const Block b) { return _mm256_or_si256(a, b); }
+inline Block butNot(const Block a, const Block b) { return _mm256_andnot_si256(b, a); }
+inline Block belowSpace(const Block a) { return _mm256_cmpeq_epi8(_mm256_max_epu8(a, splat(0x1f)), splat(0x1f)); }
+inline unsigned mask(const Block a) { return static_cast<unsigned>(_mm256_movemask_epi8(a)); }
+#elif defined(__SSE2__)
+typedef __m128i Block;
+inline Block loadBlock(const char* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+inline Block splat(const char c) { return _mm_set1_epi8(c); }
+inline Block equal(const Block a, const Block b) { return _mm_cmpeq_epi8(a, b); }
+inline Block either(const Block a, const Block b) { return _mm_or_si128(a, b); }
+inline Block butNot(const Block a, const Block b) { return _mm_andnot_si128(b, a); }
+inline Block belowSpace(const Block a) { return _mm_cmpeq_epi8(_mm_max_epu8(a, splat(0x1f)), splat(0x1f)); }
+inline unsigned mask(const Block a) { return static_cast<unsigned>(_mm_movemask_epi8(a)); }
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+/**
+ * \brief Skips the blocks that contain no special byte
+ *
+ * \param classify Function that maps a block to a block with 0xff for every special byte
+ * \return Pointer to the first special byte or to the start of the last incomplete block
+ */
+template<typename Classify>
+inline const char* skipCleanBlocks(const char* begin, const char* end, const Classify& classify)
+{
+  while(end - begin >= static_cast<long>(sizeof(Block))) {
+    const unsigned special = mask(classify(loadBlock(begin)));
+    if(special != 0) {
+      return begin + __builtin_ctz(special);
+    }
+    begin += sizeof(Block);
+  }
+  return begin;
+}
+#endif
+
+}
+
+const char* findJsonSpecial(const char* begin, const char* end)
+{
+#if defined(__AVX2__) || defined(__SSE2__)
+  begin = skipCleanBlocks(begin, end, [](const Block b) {
+    return either(either(equal(b, splat('"')), equal(b, splat('\\'))), belowSpace(b));
+  });
+#endif
+  return jsonSpecialBytes.find(begin, end);
+}
+
+const char* findXmlSpecial(const char* begin, const char* end)
+{
+#if defined(__AVX2__) || defined(__SSE2__)
+  begin = skipCleanBlocks(begin, end, [](const Block b) {
+    return either(either(either(equal(b, splat('"')), equal(b, splat('&'))), equal(b, splat('\''))),
+                  either(equal(b, splat('<')), equal(b, splat('>'))));
+  });
+#endif
+  return xmlSpecialBytes.find(begin, end);
+}
+
+const char* findXmlTextSpecial(const char* begin, const char* end, const char quoteChar)
+{
+#if defined(__AVX2__) || defined(__SSE2__)
+  begin = skipCleanBlocks(begin, end, [quoteChar](const Block b) {
+    const Block whitespace = either(either(equal(b, splat('\t')), equal(b, splat('\n'))), equal(b, splat('\r')));
+    // the mask only looks at the top bit of each byte, thus the block itself marks the non-ASCII bytes
+    return either(either(either(equal(b, splat('<')), equal(b, splat('&'))), equal(b, splat(quoteChar))),
+                  either(butNot(belowSpace(b), whitespace), b));
+  });
+#endif
+  return xmlTextSpecialBytes.find(begin, end, quoteChar);
+}
+
+}
+}
+}
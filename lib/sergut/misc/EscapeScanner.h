@@ -0,0 +1,49 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+namespace sergut {
+namespace misc {
+/**
+ * \brief Search for the bytes in a string that need escaping
+ *
+ * The functions return a pointer to the first byte in [begin, end) that
+ * has to be escaped, or \p end if there is no such byte. Clean runs are
+ * scanned 16 (SSE2) or 32 (AVX2) bytes at a time, the remainder is
+ * classified with a lookup table.
+ */
+namespace EscapeScanner {
+
+/// Finds the next '"', '\\' or control character (< 0x20) in a JSON string
+const char* findJsonSpecial(const char* begin, const char* end);
+
+/// Finds the next '"', '&', '\'', '<' or '>' in XML text
+const char* findXmlSpecial(const char* begin, const char* end);
+
+/// Finds the next byte in XML text that cannot be copied without decoding:
+/// '<', '&', \p quoteChar, a control character other than tab, LF and CR or
+/// a non-ASCII byte
+const char* findXmlTextSpecial(const char* begin, const char* end, const char quoteChar);
+
+}
+}
+}
@@ -0,0 +1,76 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "sergut/misc/MappedFile.h"
+
+#include "sergut/Exception.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+std::string errorText(const std::string& what, const std::string& path)
+{
+  return what + " '" + path + "': " + std::strerror(errno);
+}
+}
+
+sergut::misc::MappedFile::MappedFile(const std::string& path)
+{
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if(fd < 0) {
+    throw sergut::Exception(errorText("Cannot open file", path));
+  }
+  struct stat fileStatus;
+  if(::fstat(fd, &fileStatus) != 0) {
+    const std::string txt = errorText("Cannot stat file", path);
+    ::close(fd);
+    throw sergut::Exception(txt);
+  }
+  size = static_cast<std::size_t>(fileStatus.st_size);
+  if(size == 0) {
+    // an empty file cannot be mapped
+    ::close(fd);
+    return;
+  }
+  void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if(mapping == MAP_FAILED) {
+    const std::string txt = errorText("Cannot map file", path);
+    ::close(fd);
+    throw sergut::Exception(txt);
+  }
+  // the mapping stays valid after the file is closed
+  ::close(fd);
+  ::madvise(mapping, size, MADV_SEQUENTIAL);
+  data = static_cast<const char*>(mapping);
+}
+
+sergut::misc::MappedFile::~MappedFile()
+{
+  if(data != nullptr) {
+    ::munmap(const_cast<char*>(data), size);
+  }
+}
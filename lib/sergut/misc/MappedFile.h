@@ -0,0 +1,58 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "sergut/misc/ConstStringRef.h"
+
+#include <cstddef>
+#include <string>
+
+namespace sergut {
+namespace misc {
+
+/**
+ * \brief A file that is mapped read-only into memory
+ *
+ * The pages of the file are only read from disk when they are accessed and
+ * the kernel is told that the file is read sequentially, so it reads ahead
+ * and drops pages that have been passed.
+ */
+class MappedFile
+{
+public:
+  /// \throws sergut::Exception if the file cannot be opened or mapped
+  explicit MappedFile(const std::string& path);
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  const char* begin() const { return data; }
+  const char* end() const { return data + size; }
+  ConstStringRef getData() const { return ConstStringRef(begin(), end()); }
+
+private:
+  const char* data = nullptr;
+  std::size_t size = 0;
+};
+
+}
+}
@@ -0,0 +1,381 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "sergut/misc/NumberFormatter.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace sergut {
+namespace misc {
+namespace NumberFormatter {
+
+namespace {
+
+const char digitPairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+char* formatUnsigned(char* buffer, unsigned long long value)
+{
+  char tmp[20];
+  char* pos = tmp + sizeof(tmp);
+  while(value >= 100) {
+    const unsigned idx = static_cast<unsigned>(value % 100) * 2;
+    value /= 100;
+    *--pos = digitPairs[idx + 1];
+    *--pos = digitPairs[idx];
+  }
+  if(value >= 10) {
+    const unsigned idx = static_cast<unsigned>(value) * 2;
+    *--pos = digitPairs[idx + 1];
+    *--pos = digitPairs[idx];
+  } else {
+    *--pos = static_cast<char>('0' + value);
+  }
+  const std::size_t size = tmp + sizeof(tmp) - pos;
+  std::memcpy(buffer, pos, size);
+  return buffer + size;
+}
+
+// Grisu2 as described in Florian Loitsch: "Printing Floating-Point Numbers
+// Quickly and Accurately with Integers", PLDI 2010
+
+/// Floating point number f * 2^e with a 64 bit significand
+struct DiyFp {
+  DiyFp(const std::uint64_t pF, const int pE) : f(pF), e(pE) { }
+
+  DiyFp operator-(const DiyFp& rhs) const {
+    return DiyFp(f - rhs.f, e);
+  }
+
+  /// Multiplication that keeps the (rounded) upper 64 bits of the product
+  DiyFp operator*(const DiyFp& rhs) const {
+    const std::uint64_t mask32 = 0xFFFFFFFF;
+    const std::uint64_t a = f >> 32;
+    const std::uint64_t b = f & mask32;
+    const std::uint64_t c = rhs.f >> 32;
+    const std::uint64_t d = rhs.f & mask32;
+    const std::uint64_t ac = a * c;
+    const std::uint64_t bc = b * c;
+    const std::uint64_t ad = a * d;
+    const std::uint64_t bd = b * d;
+    std::uint64_t tmp = (bd >> 32) + (ad & mask32) + (bc & mask32);
+    tmp += std::uint64_t(1) << 31;
+    return DiyFp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), e + rhs.e + 64);
+  }
+
+  DiyFp normalize() const {
+    DiyFp res = *this;
+    while(!(res.f & (std::uint64_t(1) << 63))) {
+      res.f <<= 1;
+      --res.e;
+    }
+    return res;
+  }
+
+  std::uint64_t f;
+  int e;
+};
+
+/// Normalized significands and binary exponents of 10^-348, 10^-340, ..., 10^340
+const std::uint64_t cachedPowersF[] = {
+  UINT64_C(0xfa8fd5a0081c0288), UINT64_C(0xbaaee17fa23ebf76), UINT64_C(0x8b16fb203055ac76),
+  UINT64_C(0xcf42894a5dce35ea), UINT64_C(0x9a6bb0aa55653b2d), UINT64_C(0xe61acf033d1a45df),
+  UINT64_C(0xab70fe17c79ac6ca), UINT64_C(0xff77b1fcbebcdc4f), UINT64_C(0xbe5691ef416bd60c),
+  UINT64_C(0x8dd01fad907ffc3c), UINT64_C(0xd3515c2831559a83), UINT64_C(0x9d71ac8fada6c9b5),
+  UINT64_C(0xea9c227723ee8bcb), UINT64_C(0xaecc49914078536d), UINT64_C(0x823c12795db6ce57),
+  UINT64_C(0xc21094364dfb5637), UINT64_C(0x9096ea6f3848984f), UINT64_C(0xd77485cb25823ac7),
+  UINT64_C(0xa086cfcd97bf97f4), UINT64_C(0xef340a98172aace5), UINT64_C(0xb23867fb2a35b28e),
+  UINT64_C(0x84c8d4dfd2c63f3b), UINT64_C(0xc5dd44271ad3cdba), UINT64_C(0x936b9fcebb25c996),
+  UINT64_C(0xdbac6c247d62a584), UINT64_C(0xa3ab66580d5fdaf6), UINT64_C(0xf3e2f893dec3f126),
+  UINT64_C(0xb5b5ada8aaff80b8), UINT64_C(0x87625f056c7c4a8b), UINT64_C(0xc9bcff6034c13053),
+  UINT64_C(0x964e858c91ba2655), UINT64_C(0xdff9772470297ebd), UINT64_C(0xa6dfbd9fb8e5b88f),
+  UINT64_C(0xf8a95fcf88747d94), UINT64_C(0xb94470938fa89bcf), UINT64_C(0x8a08f0f8bf0f156b),
+  UINT64_C(0xcdb02555653131b6), UINT64_C(0x993fe2c6d07b7fac), UINT64_C(0xe45c10c42a2b3b06),
+  UINT64_C(0xaa242499697392d3), UINT64_C(0xfd87b5f28300ca0e), UINT64_C(0xbce5086492111aeb),
+  UINT64_C(0x8cbccc096f5088cc), UINT64_C(0xd1b71758e219652c), UINT64_C(0x9c40000000000000),
+  UINT64_C(0xe8d4a51000000000), UINT64_C(0xad78ebc5ac620000), UINT64_C(0x813f3978f8940984),
+  UINT64_C(0xc097ce7bc90715b3), UINT64_C(0x8f7e32ce7bea5c70), UINT64_C(0xd5d238a4abe98068),
+  UINT64_C(0x9f4f2726179a2245), UINT64_C(0xed63a231d4c4fb27), UINT64_C(0xb0de65388cc8ada8),
+  UINT64_C(0x83c7088e1aab65db), UINT64_C(0xc45d1df942711d9a), UINT64_C(0x924d692ca61be758),
+  UINT64_C(0xda01ee641a708dea), UINT64_C(0xa26da3999aef774a), UINT64_C(0xf209787bb47d6b85),
+  UINT64_C(0xb454e4a179dd1877), UINT64_C(0x865b86925b9bc5c2), UINT64_C(0xc83553c5c8965d3d),
+  UINT64_C(0x952ab45cfa97a0b3), UINT64_C(0xde469fbd99a05fe3), UINT64_C(0xa59bc234db398c25),
+  UINT64_C(0xf6c69a72a3989f5c), UINT64_C(0xb7dcbf5354e9bece), UINT64_C(0x88fcf317f22241e2),
+  UINT64_C(0xcc20ce9bd35c78a5), UINT64_C(0x98165af37b2153df), UINT64_C(0xe2a0b5dc971f303a),
+  UINT64_C(0xa8d9d1535ce3b396), UINT64_C(0xfb9b7cd9a4a7443c), UINT64_C(0xbb764c4ca7a44410),
+  UINT64_C(0x8bab8eefb6409c1a), UINT64_C(0xd01fef10a657842c), UINT64_C(0x9b10a4e5e9913129),
+  UINT64_C(0xe7109bfba19c0c9d), UINT64_C(0xac2820d9623bf429), UINT64_C(0x80444b5e7aa7cf85),
+  UINT64_C(0xbf21e44003acdd2d), UINT64_C(0x8e679c2f5e44ff8f), UINT64_C(0xd433179d9c8cb841),
+  UINT64_C(0x9e19db92b4e31ba9), UINT64_C(0xeb96bf6ebadf77d9), UINT64_C(0xaf87023b9bf0ee6b)
+};
+
+const std::int16_t cachedPowersE[] = {
+  -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+  -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+  -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+  -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+  -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+  109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+  375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+  641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+  907, 933, 960, 986, 1013, 1039, 1066
+};
+
+/// Returns a power of ten 10^-k that scales a number with binary exponent \p e into [2^-60, 2^-32]
+DiyFp getCachedPower(const int e, int& k)
+{
+  const double dk = (-61 - e) * 0.30102999566398114 + 347;
+  int ik = static_cast<int>(dk);
+  if(ik != dk) {
+    ++ik;
+  }
+  const unsigned index = static_cast<unsigned>((ik >> 3) + 1);
+  k = -(-348 + static_cast<int>(index << 3));
+  return DiyFp(cachedPowersF[index], cachedPowersE[index]);
+}
+
+const std::uint64_t powersOf10[] = {
+  UINT64_C(1), UINT64_C(10), UINT64_C(100), UINT64_C(1000), UINT64_C(10000), UINT64_C(100000),
+  UINT64_C(1000000), UINT64_C(10000000), UINT64_C(100000000), UINT64_C(1000000000),
+  UINT64_C(10000000000), UINT64_C(100000000000), UINT64_C(1000000000000), UINT64_C(10000000000000),
+  UINT64_C(100000000000000), UINT64_C(1000000000000000), UINT64_C(10000000000000000),
+  UINT64_C(100000000000000000), UINT64_C(1000000000000000000), UINT64_C(10000000000000000000)
+};
+
+void grisuRound(char* buffer, const int len, const std::uint64_t delta, std::uint64_t rest,
+                const std::uint64_t tenKappa, const std::uint64_t wpW)
+{
+  while(rest < wpW && delta - rest >= tenKappa &&
+        (rest + tenKappa < wpW || wpW - rest > rest + tenKappa - wpW)) {
+    --buffer[len - 1];
+    rest += tenKappa;
+  }
+}
+
+int countDecimalDigits(const std::uint32_t n)
+{
+  int digits = 1;
+  while(digits < 10 && n >= powersOf10[digits]) {
+    ++digits;
+  }
+  return digits;
+}
+
+/// Generates the digits of \p mp until the result lies within \p delta of it
+void digitGen(const DiyFp& w, const DiyFp& mp, std::uint64_t delta, char* buffer, int& len, int& k)
+{
+  const DiyFp one(std::uint64_t(1) << -mp.e, mp.e);
+  const DiyFp wpW = mp - w;
+  std::uint32_t p1 = static_cast<std::uint32_t>(mp.f >> -one.e);
+  std::uint64_t p2 = mp.f & (one.f - 1);
+  int kappa = countDecimalDigits(p1);
+  len = 0;
+  while(kappa > 0) {
+    const std::uint32_t divisor = static_cast<std::uint32_t>(powersOf10[kappa - 1]);
+    const std::uint32_t d = p1 / divisor;
+    p1 %= divisor;
+    if(d || len) {
+      buffer[len++] = static_cast<char>('0' + d);
+    }
+    --kappa;
+    const std::uint64_t tmp = (static_cast<std::uint64_t>(p1) << -one.e) + p2;
+    if(tmp <= delta) {
+      k += kappa;
+      grisuRound(buffer, len, delta, tmp, powersOf10[kappa] << -one.e, wpW.f);
+      return;
+    }
+  }
+  while(true) {
+    p2 *= 10;
+    delta *= 10;
+    const char d = static_cast<char>(p2 >> -one.e);
+    if(d || len) {
+      buffer[len++] = static_cast<char>('0' + d);
+    }
+    p2 &= one.f - 1;
+    --kappa;
+    if(p2 < delta) {
+      k += kappa;
+      grisuRound(buffer, len, delta, p2, one.f, -kappa < 20 ? wpW.f * powersOf10[-kappa] : 0);
+      return;
+    }
+  }
+}
+
+/**
+ * \brief Computes the shortest digits of the positive number f * 2^e
+ *
+ * \param hiddenBit The implicit leading bit of the floating point type
+ * \param digits Receives the digits, must hold at least 18 characters
+ * \param len Receives the number of digits
+ * \param k Receives the decimal exponent, the number is digits * 10^k
+ */
+void grisu2(const std::uint64_t f, const int e, const std::uint64_t hiddenBit,
+            char* digits, int& len, int& k)
+{
+  const DiyFp plus = DiyFp((f << 1) + 1, e - 1).normalize();
+  DiyFp minus = (f == hiddenBit) ? DiyFp((f << 2) - 1, e - 2) : DiyFp((f << 1) - 1, e - 1);
+  minus.f <<= minus.e - plus.e;
+  minus.e = plus.e;
+
+  const DiyFp cachedPower = getCachedPower(plus.e, k);
+  const DiyFp w = DiyFp(f, e).normalize() * cachedPower;
+  DiyFp wPlus = plus * cachedPower;
+  DiyFp wMinus = minus * cachedPower;
+  ++wMinus.f;
+  --wPlus.f;
+  digitGen(w, wPlus, wPlus.f - wMinus.f, digits, len, k);
+}
+
+/// Writes digits * 10^k in the notation of printf("%g") without limiting the precision
+char* writeDecimal(char* buffer, const char* digits, const int len, const int k)
+{
+  const int exponent = len + k - 1;
+  if(exponent >= -4 && exponent < 17) {
+    if(k >= 0) {
+      std::memcpy(buffer, digits, len);
+      buffer += len;
+      std::memset(buffer, '0', k);
+      return buffer + k;
+    }
+    if(exponent >= 0) {
+      std::memcpy(buffer, digits, exponent + 1);
+      buffer += exponent + 1;
+      *buffer++ = '.';
+      std::memcpy(buffer, digits + exponent + 1, len - exponent - 1);
+      return buffer + len - exponent - 1;
+    }
+    *buffer++ = '0';
+    *buffer++ = '.';
+    std::memset(buffer, '0', -exponent - 1);
+    buffer += -exponent - 1;
+    std::memcpy(buffer, digits, len);
+    return buffer + len;
+  }
+  *buffer++ = digits[0];
+  if(len > 1) {
+    *buffer++ = '.';
+    std::memcpy(buffer, digits + 1, len - 1);
+    buffer += len - 1;
+  }
+  *buffer++ = 'e';
+  *buffer++ = exponent < 0 ? '-' : '+';
+  const int absExponent = exponent < 0 ? -exponent : exponent;
+  if(absExponent < 10) {
+    *buffer++ = '0';
+  }
+  return formatUnsigned(buffer, static_cast<unsigned long long>(absExponent));
+}
+
+template<typename FloatType>
+char* formatNonFinite(char* buffer, const FloatType value)
+{
+  if(std::isnan(value)) {
+    std::memcpy(buffer, "nan", 3);
+    return buffer + 3;
+  }
+  if(value < 0) {
+    *buffer++ = '-';
+  }
+  std::memcpy(buffer, "inf", 3);
+  return buffer + 3;
+}
+
+/**
+ * \brief Formats a finite IEEE 754 number given by its bit pattern
+ *
+ * \param significandBits Number of explicitly stored bits of the significand
+ * \param exponentBias Bias of the exponent including the size of the significand
+ */
+template<typename UInt, int significandBits, int exponentBits, int exponentBias>
+char* formatFloatingPoint(char* buffer, const UInt bits)
+{
+  const UInt hiddenBit = UInt(1) << significandBits;
+  const UInt significand = bits & (hiddenBit - 1);
+  const int biasedExponent = static_cast<int>((bits >> significandBits) & ((UInt(1) << exponentBits) - 1));
+  if((bits >> (significandBits + exponentBits)) != 0) {
+    *buffer++ = '-';
+  }
+  if(biasedExponent == 0 && significand == 0) {
+    *buffer = '0';
+    return buffer + 1;
+  }
+  char digits[20];
+  int len = 0;
+  int k = 0;
+  if(biasedExponent != 0) {
+    grisu2(significand | hiddenBit, biasedExponent - exponentBias, hiddenBit, digits, len, k);
+  } else {
+    grisu2(significand, 1 - exponentBias, hiddenBit, digits, len, k);
+  }
+  return writeDecimal(buffer, digits, len, k);
+}
+
+}
+
+char* format(char* buffer, const long long value)
+{
+  if(value < 0) {
+    *buffer++ = '-';
+    return formatUnsigned(buffer, 0 - static_cast<unsigned long long>(value));
+  }
+  return formatUnsigned(buffer, static_cast<unsigned long long>(value));
+}
+
+char* format(char* buffer, const unsigned long long value)
+{
+  return formatUnsigned(buffer, value);
+}
+
+char* format(char* buffer, const double value)
+{
+  if(!std::isfinite(value)) {
+    return formatNonFinite(buffer, value);
+  }
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return formatFloatingPoint<std::uint64_t, 52, 11, 1075>(buffer, bits);
+}
+
+char* format(char* buffer, const float value)
+{
+  if(!std::isfinite(value)) {
+    return formatNonFinite(buffer, value);
+  }
+  std::uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return formatFloatingPoint<std::uint32_t, 23, 8, 150>(buffer, bits);
+}
+
+}
+}
+}
@@ -0,0 +1,61 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace sergut {
+namespace misc {
+/**
+ * \brief Locale independent formatting of numbers into a character buffer
+ *
+ * The functions write the textual representation of the number to \p buffer
+ * and return a pointer behind the last written character. The buffer must
+ * be at least \c maxLength characters long, the result is not
+ * NUL-terminated.
+ *
+ * Floating point numbers are written with the shortest sequence of digits
+ * that reads back to the same value (Grisu2). The notation follows the
+ * one of \c printf("%g"), i.e. 0.25, 1e+20 or 2.5e-06, but never drops
+ * significant digits. Non finite values are written as \c nan, \c inf and
+ * \c -inf.
+ */
+namespace NumberFormatter {
+
+/// Number of characters that suffice for every formatted number
+constexpr std::size_t maxLength = 32;
+
+char* format(char* buffer, long long value);
+char* format(char* buffer, unsigned long long value);
+char* format(char* buffer, double value);
+char* format(char* buffer, float value);
+
+inline char* format(char* buffer, long value) { return format(buffer, static_cast<long long>(value)); }
+inline char* format(char* buffer, int value) { return format(buffer, static_cast<long long>(value)); }
+inline char* format(char* buffer, short value) { return format(buffer, static_cast<long long>(value)); }
+inline char* format(char* buffer, unsigned long value) { return format(buffer, static_cast<unsigned long long>(value)); }
+inline char* format(char* buffer, unsigned int value) { return format(buffer, static_cast<unsigned long long>(value)); }
+inline char* format(char* buffer, unsigned short value) { return format(buffer, static_cast<unsigned long long>(value)); }
+
+}
+}
+}
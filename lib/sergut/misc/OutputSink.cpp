@@ -0,0 +1,101 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "sergut/misc/OutputSink.h"
+
+#include "sergut/SerializationException.h"
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <unistd.h>
+
+namespace sergut {
+namespace misc {
+
+OutputSink::~OutputSink() { }
+
+BufferedSink::BufferedSink(const std::size_t bufferSize)
+  : buffer(std::max(bufferSize, std::size_t(1)))
+{
+  setBuffer(buffer.data(), buffer.data() + buffer.size());
+}
+
+BufferedSink::~BufferedSink() { }
+
+void BufferedSink::flush()
+{
+  const std::size_t used = writePointer - buffer.data();
+  // reset first, so that the buffer is not handed over twice if consume() throws
+  setBuffer(buffer.data(), buffer.data() + buffer.size());
+  if(used != 0) {
+    consume(buffer.data(), used);
+  }
+}
+
+void BufferedSink::overflow(const char* data, const std::size_t size)
+{
+  flush();
+  if(size >= buffer.size()) {
+    consume(data, size);
+    return;
+  }
+  std::memcpy(writePointer, data, size);
+  writePointer += size;
+}
+
+CallbackSink::CallbackSink(const Callback& pCallback, const std::size_t bufferSize)
+  : BufferedSink(bufferSize)
+  , callback(pCallback)
+{ }
+
+CallbackSink::~CallbackSink() { }
+
+void CallbackSink::consume(const char* data, const std::size_t size)
+{
+  callback(data, size);
+}
+
+FileDescriptorSink::FileDescriptorSink(const int pFd, const std::size_t bufferSize)
+  : BufferedSink(bufferSize)
+  , fd(pFd)
+{ }
+
+FileDescriptorSink::~FileDescriptorSink() { }
+
+void FileDescriptorSink::consume(const char* data, const std::size_t size)
+{
+  std::size_t written = 0;
+  while(written < size) {
+    const ssize_t res = ::write(fd, data + written, size - written);
+    if(res < 0) {
+      if(errno == EINTR) {
+        continue;
+      }
+      throw SerializationException(std::string("Error writing to file descriptor: ") + std::strerror(errno));
+    }
+    written += static_cast<std::size_t>(res);
+  }
+}
+
+}
+}
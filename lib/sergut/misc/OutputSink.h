@@ -0,0 +1,241 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "sergut/misc/ConstStringRef.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace sergut {
+namespace misc {
+
+/**
+ * \brief Destination for the bytes that are produced by a serializer.
+ *
+ * The sink exposes a contiguous buffer, into which \c write() copies the data
+ * directly. Only when this buffer is exhausted the virtual function
+ * \c overflow() is called, which has to make room for the data (by growing
+ * the buffer or by handing its content on to the final destination).
+ *
+ * Call \c flush() when done writing, to ensure that all data has arrived at
+ * the final destination.
+ */
+class OutputSink
+{
+public:
+  OutputSink() = default;
+  OutputSink(const OutputSink&) = delete;
+  OutputSink& operator=(const OutputSink&) = delete;
+  virtual ~OutputSink();
+
+  void write(const char* data, const std::size_t size) {
+    if(static_cast<std::size_t>(bufferEnd - writePointer) < size) {
+      overflow(data, size);
+      return;
+    }
+    std::memcpy(writePointer, data, size);
+    writePointer += size;
+  }
+
+  void write(const char c) {
+    if(writePointer == bufferEnd) {
+      overflow(&c, 1);
+      return;
+    }
+    *writePointer = c;
+    ++writePointer;
+  }
+
+  void write(const ConstStringRef& str) { write(str.begin(), str.size()); }
+
+  /// \brief Hand over all data written so far to the final destination.
+  virtual void flush() = 0;
+
+protected:
+  /**
+   * \brief Called by \c write() when \c size bytes do not fit into the buffer
+   *
+   * Implementations have to consume \c data and set up a new buffer using
+   * \c setBuffer().
+   */
+  virtual void overflow(const char* data, const std::size_t size) = 0;
+
+  void setBuffer(char* pWritePointer, char* pBufferEnd) {
+    writePointer = pWritePointer;
+    bufferEnd = pBufferEnd;
+  }
+
+protected:
+  char* writePointer = nullptr;
+  char* bufferEnd = nullptr;
+};
+
+/**
+ * \brief Sink that writes into a growable contiguous container
+ *
+ * \c Container can be \c std::string or \c std::vector<char>. The sink either
+ * owns the container or appends to one that is provided by the caller. While
+ * writing, the container is larger than the data that has been written, so it
+ * only has its final size after \c flush() has been called.
+ */
+template<typename Container>
+class ContainerSink: public OutputSink
+{
+public:
+  ContainerSink() : container(&ownContainer) { }
+  /// \param pContainer The data is appended to this container, which has to
+  ///        outlive the sink.
+  explicit ContainerSink(Container& pContainer) : container(&pContainer) { }
+  ~ContainerSink() { flush(); }
+
+  void flush() override {
+    if(writePointer == nullptr) {
+      return;
+    }
+    container->resize(writePointer - bufferStart());
+    // the next write() grows the container again, reusing its capacity
+    setBuffer(nullptr, nullptr);
+  }
+
+  /// \brief Get the data written so far.
+  const Container& data() {
+    flush();
+    return *container;
+  }
+
+  /**
+   * \brief Hand over the container without copying it
+   *
+   * Afterwards the sink is empty and can be reused.
+   */
+  Container take() {
+    flush();
+    Container ret;
+    std::swap(ret, *container);
+    return ret;
+  }
+
+  /// \brief Discard the data, the container keeps its capacity
+  void clear() {
+    container->clear();
+    setBuffer(nullptr, nullptr);
+  }
+
+protected:
+  void overflow(const char* data, const std::size_t size) override {
+    const std::size_t used = writePointer == nullptr ? container->size() : writePointer - bufferStart();
+    const std::size_t newSize = std::max(std::max(used + size, 2 * container->size()),
+                                         std::max(container->capacity(), std::size_t(256)));
+    container->resize(newSize);
+    char* const start = bufferStart();
+    std::memcpy(start + used, data, size);
+    setBuffer(start + used + size, start + newSize);
+  }
+
+private:
+  char* bufferStart() { return &*container->begin(); }
+
+private:
+  Container ownContainer;
+  Container* container;
+};
+
+typedef ContainerSink<std::string> StringSink;
+typedef ContainerSink<std::vector<char>> VectorSink;
+
+/**
+ * \brief Sink that streams the data in chunks to its final destination
+ *
+ * The data is collected in a buffer of fixed size. Whenever it is full, the
+ * content is handed over via \c consume(), so the memory consumption only
+ * depends on \c bufferSize and not on the amount of data written. Writes
+ * that are larger than the buffer are passed on directly.
+ *
+ * As consuming the data might throw, the destructor does not flush, so
+ * \c flush() has to be called explicitly after the last write.
+ */
+class BufferedSink: public OutputSink
+{
+public:
+  static const std::size_t defaultBufferSize = 64 * 1024;
+
+  explicit BufferedSink(const std::size_t bufferSize = defaultBufferSize);
+  ~BufferedSink();
+
+  void flush() override;
+
+protected:
+  /// \brief Hand over \c size bytes to the final destination.
+  virtual void consume(const char* data, const std::size_t size) = 0;
+
+  void overflow(const char* data, const std::size_t size) override;
+
+private:
+  std::vector<char> buffer;
+};
+
+/**
+ * \brief Sink that hands the data over to a callback function
+ *
+ * The callback is called with a chunk of data whenever \c bufferSize bytes
+ * have been collected and on \c flush().
+ */
+class CallbackSink: public BufferedSink
+{
+public:
+  typedef std::function<void(const char* data, std::size_t size)> Callback;
+
+  explicit CallbackSink(const Callback& pCallback, const std::size_t bufferSize = defaultBufferSize);
+  ~CallbackSink();
+
+protected:
+  void consume(const char* data, const std::size_t size) override;
+
+private:
+  Callback callback;
+};
+
+/**
+ * \brief Sink that writes into a file descriptor (file, pipe, socket, ...)
+ *
+ * The file descriptor is not closed by the sink. A failing \c write() is
+ * reported by throwing a \c SerializationException.
+ */
+class FileDescriptorSink: public BufferedSink
+{
+public:
+  explicit FileDescriptorSink(const int pFd, const std::size_t bufferSize = defaultBufferSize);
+  ~FileDescriptorSink();
+
+protected:
+  void consume(const char* data, const std::size_t size) override;
+
+private:
+  int fd;
+};
+
+}
+}
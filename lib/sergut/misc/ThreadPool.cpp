@@ -0,0 +1,120 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "sergut/misc/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace sergut {
+namespace misc {
+
+ThreadPool::ThreadPool(const std::size_t threadCount)
+{
+  threads.reserve(threadCount);
+  for(std::size_t i = 0; i < threadCount; ++i) {
+    threads.emplace_back([this]() { workerLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  jobAvailable.notify_all();
+  for(std::thread& thread: threads) {
+    thread.join();
+  }
+}
+
+void ThreadPool::parallelFor(const std::size_t count, const std::function<void(std::size_t)>& task)
+{
+  std::atomic<std::size_t> nextIndex(0);
+  std::exception_ptr exception;
+  std::mutex doneMutex;
+  std::condition_variable allDone;
+  std::size_t runningHelpers = 0;
+
+  // Processes indices until none are left, shared by the calling thread and the helpers
+  const auto process = [&]() {
+    std::size_t index;
+    while((index = nextIndex.fetch_add(1)) < count) {
+      try {
+        task(index);
+      } catch(...) {
+        nextIndex = count;
+        std::lock_guard<std::mutex> lock(doneMutex);
+        if(!exception) {
+          exception = std::current_exception();
+        }
+      }
+    }
+  };
+
+  const std::size_t helperCount = std::min(threads.size(), count == 0 ? 0 : count - 1);
+  if(helperCount != 0) {
+    runningHelpers = helperCount;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      for(std::size_t i = 0; i < helperCount; ++i) {
+        jobs.push_back([&]() {
+          process();
+          std::lock_guard<std::mutex> lock(doneMutex);
+          if(--runningHelpers == 0) {
+            allDone.notify_one();
+          }
+        });
+      }
+    }
+    jobAvailable.notify_all();
+  }
+
+  process();
+
+  std::unique_lock<std::mutex> lock(doneMutex);
+  allDone.wait(lock, [&]() { return runningHelpers == 0; });
+  if(exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
+void ThreadPool::workerLoop()
+{
+  while(true) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      jobAvailable.wait(lock, [this]() { return stopping || !jobs.empty(); });
+      if(jobs.empty()) {
+        return;
+      }
+      job = std::move(jobs.front());
+      jobs.pop_front();
+    }
+    job();
+  }
+}
+
+}
+}
@@ -0,0 +1,71 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sergut {
+namespace misc {
+
+/**
+ * \brief A fixed number of worker threads to run independent tasks on
+ */
+class ThreadPool
+{
+public:
+  /// \param threadCount The number of worker threads, 0 runs everything on the calling thread
+  explicit ThreadPool(const std::size_t threadCount);
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ~ThreadPool();
+
+  std::size_t threadCount() const { return threads.size(); }
+
+  /**
+   * \brief Calls \c task for each index in [0, count) and waits until all calls are done
+   *
+   * The calling thread takes part in processing the tasks. If a task
+   * throws, the remaining indices are skipped and the first exception is
+   * rethrown on the calling thread.
+   * \note Must not be called from within a task of the same pool.
+   */
+  void parallelFor(const std::size_t count, const std::function<void(std::size_t)>& task);
+
+private:
+  void workerLoop();
+
+private:
+  std::mutex mutex;
+  std::condition_variable jobAvailable;
+  std::deque<std::function<void()>> jobs;
+  bool stopping = false;
+  std::vector<std::thread> threads;
+};
+
+}
+}
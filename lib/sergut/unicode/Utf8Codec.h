@@ -40,11 +40,6 @@ struct Utf8Codec {
   //  1110 xxxx xxxx xxxx xxxx xxxx
   //  1111 0xxx xxxx xxxx xxxx xxxx xxxx xxxx
 
-    if((firstChar & 0x80) == 0) {
-      firstCharValue = firstChar;
-      return ParseResult(1);
-    }
-
     if((firstChar & 0x80) == 0) {
       firstCharValue = firstChar;
       return ParseResult(1);
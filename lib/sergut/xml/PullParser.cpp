@@ -21,26 +21,34 @@
 
 #include "sergut/xml/PullParser.h"
 
+#include "sergut/misc/MappedFile.h"
 #include "sergut/unicode/Utf16Codec.h"
 #include "sergut/unicode/Utf8Codec.h"
 #include "sergut/xml/detail/PullParserUtf16BE.h"
 #include "sergut/xml/detail/PullParserUtf16LE.h"
 #include "sergut/xml/detail/PullParserUtf8.h"
 
+#include <algorithm>
+
 sergut::xml::PullParser::~PullParser() { }
 
 std::unique_ptr<sergut::xml::PullParser> sergut::xml::PullParser::createParser(const sergut::misc::ConstStringRef& data)
+{
+  return createParser(data, DataOwnership::Copy);
+}
+
+std::unique_ptr<sergut::xml::PullParser> sergut::xml::PullParser::createParser(const sergut::misc::ConstStringRef& data, const DataOwnership ownership)
 {
   if(sergut::unicode::Utf16BECodec::hasBom(data.begin(), data.end())) {
-    return std::unique_ptr<sergut::xml::detail::PullParserUtf16BE>(new sergut::xml::detail::PullParserUtf16BE(sergut::misc::ConstStringRef(data.begin()+2, data.end())));
+    return std::unique_ptr<sergut::xml::detail::PullParserUtf16BE>(new sergut::xml::detail::PullParserUtf16BE(sergut::misc::ConstStringRef(data.begin()+2, data.end()), ownership));
   }
   if(sergut::unicode::Utf16LECodec::hasBom(data.begin(), data.end())) {
-    return std::unique_ptr<sergut::xml::detail::PullParserUtf16LE>(new sergut::xml::detail::PullParserUtf16LE(sergut::misc::ConstStringRef(data.begin()+2, data.end())));
+    return std::unique_ptr<sergut::xml::detail::PullParserUtf16LE>(new sergut::xml::detail::PullParserUtf16LE(sergut::misc::ConstStringRef(data.begin()+2, data.end()), ownership));
   }
   if(sergut::unicode::Utf8Codec::hasBom(data.begin(), data.end())) {
-    return std::unique_ptr<sergut::xml::detail::PullParserUtf8>(new sergut::xml::detail::PullParserUtf8(sergut::misc::ConstStringRef(data.begin()+3, data.end())));
+    return std::unique_ptr<sergut::xml::detail::PullParserUtf8>(new sergut::xml::detail::PullParserUtf8(sergut::misc::ConstStringRef(data.begin()+3, data.end()), ownership));
   }
-  return std::unique_ptr<sergut::xml::detail::PullParserUtf8>(new sergut::xml::detail::PullParserUtf8(sergut::misc::ConstStringRef(data.begin(), data.end())));
+  return std::unique_ptr<sergut::xml::detail::PullParserUtf8>(new sergut::xml::detail::PullParserUtf8(sergut::misc::ConstStringRef(data.begin(), data.end()), ownership));
 }
 
 std::unique_ptr<sergut::xml::PullParser> sergut::xml::PullParser::createParser(std::vector<char>&& data)
@@ -56,3 +64,43 @@ std::unique_ptr<sergut::xml::PullParser> sergut::xml::PullParser::createParser(s
   }
   return std::unique_ptr<sergut::xml::detail::PullParserUtf8>(new sergut::xml::detail::PullParserUtf8(std::move(data), 0));
 }
+
+std::unique_ptr<sergut::xml::PullParser> sergut::xml::PullParser::createParserFromFile(const std::string& path)
+{
+  std::unique_ptr<const sergut::misc::MappedFile> file(new sergut::misc::MappedFile(path));
+  if(sergut::unicode::Utf16BECodec::hasBom(file->begin(), file->end())) {
+    return std::unique_ptr<sergut::xml::detail::PullParserUtf16BE>(new sergut::xml::detail::PullParserUtf16BE(std::move(file), 2));
+  }
+  if(sergut::unicode::Utf16LECodec::hasBom(file->begin(), file->end())) {
+    return std::unique_ptr<sergut::xml::detail::PullParserUtf16LE>(new sergut::xml::detail::PullParserUtf16LE(std::move(file), 2));
+  }
+  if(sergut::unicode::Utf8Codec::hasBom(file->begin(), file->end())) {
+    return std::unique_ptr<sergut::xml::detail::PullParserUtf8>(new sergut::xml::detail::PullParserUtf8(std::move(file), 3));
+  }
+  return std::unique_ptr<sergut::xml::detail::PullParserUtf8>(new sergut::xml::detail::PullParserUtf8(std::move(file), 0));
+}
+
+std::unique_ptr<sergut::xml::PullParser> sergut::xml::PullParser::createParser(sergut::misc::InputSource& source, const std::size_t chunkSize)
+{
+  const std::size_t readChunkSize = std::max(chunkSize, std::size_t(1));
+  // read enough data to detect the BOM
+  std::vector<char> data;
+  std::size_t readSize = 0;
+  do {
+    const std::size_t oldSize = data.size();
+    data.resize(oldSize + readChunkSize);
+    readSize = source.read(data.data() + oldSize, readChunkSize);
+    data.resize(oldSize + readSize);
+  } while(data.size() < 4 && readSize != 0);
+
+  if(sergut::unicode::Utf16BECodec::hasBom(data.data(), data.data() + data.size())) {
+    return std::unique_ptr<sergut::xml::detail::PullParserUtf16BE>(new sergut::xml::detail::PullParserUtf16BE(std::move(data), 2, source, readChunkSize));
+  }
+  if(sergut::unicode::Utf16LECodec::hasBom(data.data(), data.data() + data.size())) {
+    return std::unique_ptr<sergut::xml::detail::PullParserUtf16LE>(new sergut::xml::detail::PullParserUtf16LE(std::move(data), 2, source, readChunkSize));
+  }
+  if(sergut::unicode::Utf8Codec::hasBom(data.data(), data.data() + data.size())) {
+    return std::unique_ptr<sergut::xml::detail::PullParserUtf8>(new sergut::xml::detail::PullParserUtf8(std::move(data), 3, source, readChunkSize));
+  }
+  return std::unique_ptr<sergut::xml::detail::PullParserUtf8>(new sergut::xml::detail::PullParserUtf8(std::move(data), 0, source, readChunkSize));
+}
@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include "sergut/misc/InputSource.h"
 #include "sergut/misc/StringRef.h"
 #include "sergut/xml/ParseTokenType.h"
 
@@ -43,10 +44,27 @@ namespace xml {
  * until you reach the end of the XML snippet, restore the save point, append
  * further data and continue parsing. This is convenient if you want to start
  * handling a document before it has completely been loaded.
+ *
+ * If a token is cut off at the end of the available data, \c parseNext()
+ * returns \c IncompleteDocument and the parser stays right before that token.
+ * After more data has been appended, the next call of \c parseNext()
+ * continues with that token, so no save point is needed to go on parsing.
+ *
+ * A parser can also borrow the data it is created with instead of copying it,
+ * see \c DataOwnership.
  */
 class PullParser
 {
 public:
+  /// How the parser accesses the data that it is created with
+  enum class DataOwnership {
+    Copy,  ///< the data is copied into the parser
+    /// The data is parsed where it is, the caller has to keep it alive and
+    /// unchanged for the lifetime of the parser. It is only copied into the
+    /// parser, when data is appended.
+    Borrow
+  };
+
   enum class DecodingResult: std::size_t {
     Empty      =                           0 ,
     Error      = static_cast<std::size_t>(-1),
@@ -64,6 +82,17 @@ public:
    */
   static std::unique_ptr<PullParser> createParser(const sergut::misc::ConstStringRef& data);
 
+  /**
+   * \brief factory function for \c PullParser that may borrow the data
+   *
+   * \param data XML-data that can be encoded in either UTF-8, UTF-16LE, or
+   *        UTF-16BE.
+   * \param ownership With \c DataOwnership::Borrow \c data has to outlive
+   *        the parser.
+   * \return a \c PullParser.
+   */
+  static std::unique_ptr<PullParser> createParser(const sergut::misc::ConstStringRef& data, const DataOwnership ownership);
+
   /**
    * \brief factory function for \c PullParser for moving the data ownership
    * into the parser
@@ -77,6 +106,33 @@ public:
    */
   static std::unique_ptr<PullParser> createParser(std::vector<char>&& data);
 
+  /**
+   * \brief factory function for \c PullParser that parses a file
+   *
+   * The file is mapped read-only into memory and parsed directly from the
+   * mapping, which is released when data is appended to the parser. The
+   * encoding is detected as in \c createParser().
+   * \param path The path of the XML file.
+   * \return a \c PullParser.
+   * \throws sergut::Exception if the file cannot be opened or mapped.
+   */
+  static std::unique_ptr<PullParser> createParserFromFile(const std::string& path);
+
+  /**
+   * \brief factory function for \c PullParser that reads the data from \c source
+   *
+   * The parser reads the next chunk from \c source only when the current
+   * token is incomplete, so \c parseNext() never returns
+   * \c IncompleteDocument before the end of the input has been reached. The
+   * already parsed data is compressed out of the inner buffer only when that
+   * buffer has doubled in size, which amortizes the copying. The encoding is
+   * detected as in \c createParser().
+   * \param source The source of the XML-data, it has to outlive the parser.
+   * \param chunkSize The number of bytes that are requested per read.
+   * \return a \c PullParser.
+   */
+  static std::unique_ptr<PullParser> createParser(sergut::misc::InputSource& source, const std::size_t chunkSize = 64 * 1024);
+
   virtual ~PullParser();
 
   /// \brief Export the inner XML
@@ -21,6 +21,8 @@
 
 #pragma once
 
+#include "sergut/misc/InputSource.h"
+#include "sergut/misc/MappedFile.h"
 #include "sergut/unicode/Utf32Char.h"
 #include "sergut/xml/PullParser.h"
 #include "sergut/xml/detail/ParseStack.h"
@@ -28,6 +30,7 @@
 #include "sergut/xml/detail/ReaderStateResetter.h"
 #include "sergut/xml/detail/TextDecodingHelper.h"
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include <string>
@@ -102,7 +105,12 @@ public:
   };
 
   BasicPullParser(const sergut::misc::ConstStringRef& data);
+  BasicPullParser(const sergut::misc::ConstStringRef& data, const DataOwnership ownership);
   BasicPullParser(std::vector<char>&& data, const std::size_t offset);
+  /// Parses the mapped file starting at \c offset, the parser keeps the mapping until data is appended
+  BasicPullParser(std::unique_ptr<const sergut::misc::MappedFile>&& file, const std::size_t offset);
+  /// Parses \c data starting at \c offset and reads more data from \c source whenever it is needed
+  BasicPullParser(std::vector<char>&& data, const std::size_t offset, sergut::misc::InputSource& source, const std::size_t chunkSize);
   std::vector<char>&& extractXmlData() override;
   ParseTokenType parseNext() override;
   ParseTokenType getCurrentTokenType() const override;
@@ -115,12 +123,23 @@ public:
   bool restoreToSavePoint() override;
 
 private:
+  /// Copy borrowed input into inputData, such that it can be modified
+  void takeOwnershipOfInput();
+  /// Compress the inner data only if the buffer has doubled since the last
+  /// compression, such that the copying is amortized over the appended data
+  void compressInnerDataIfWorthwhile();
   void compressInnerData();
   void recomputePointersToInput(const char* oldStartOfInput);
   /** Check whether there is an XML declaration and if so whether it is correct
    * @return true if there is no XML declaration or there is one that is OK (right version and encoding)
    */
   bool handleXmlDecl();
+  ParseTokenType parseNextToken();
+  /// Read the first character of the document, if it is incomplete it is read again when data is appended
+  void readFirstChar();
+  /// Append the next chunk of inputSource to the inner data
+  /// \return false if the end of the input has been reached
+  bool readFromInputSource();
   bool skipWhitespaces();
   /**
    * Jump over the current character and set incompleteDocument == true in case it reaches the end of the buffer.
@@ -148,20 +167,44 @@ private:
   bool parseAttribute(const bool setCurrentTokenTypeToAttribute);
   bool parseText();
   bool parseCloseTag();
+  /// Sets the current value to the text that has just been decoded by \c helper
+  void setCurrentValue(const TextDecodingHelper<CharDecoder>& helper);
   bool atEnd() const;
   sergut::unicode::Utf32Char peekChar() const;
 
 private:
   friend class sergut::xml::detail::ReaderStateResetter;
+  /// empty, while the input is borrowed
   std::vector<char> inputData;
+  /// the end of the input, which is either inputData or the borrowed data
+  const char* inputEnd;
+  /// the start of the borrowed data, nullptr if the input is in inputData
+  const char* borrowedInputBegin = nullptr;
+  /// the file that the borrowed data is mapped from, if any
+  std::unique_ptr<const sergut::misc::MappedFile> mappedFile;
+  /// the source that further data is read from, if any
+  sergut::misc::InputSource* inputSource = nullptr;
+  std::size_t inputChunkSize = 4096;
+  /// the size of inputData from which on compressing it is worthwhile
+  std::size_t compressionThreshold = 0;
   ReaderState readerState;
   ParseStack<std::is_same<CharDecoder, sergut::unicode::Utf8Codec>::value> parseStack;
 
   DecodedNameBuffers<std::is_same<CharDecoder, sergut::unicode::Utf8Codec>::value> decodedNameBuffers;
   std::vector<char> decodedValueBuffer;
+  /// Refers either to decodedValueBuffer or, if the value needed no decoding, directly to inputData
+  sergut::misc::ConstStringRef currentValue;
+  bool currentValueInInputData = false;
 
   ParseTokenType currentTokenType = ParseTokenType::InitialState;
   bool incompleteDocument = true;
+  /// What is continued, when data is appended to the incomplete document
+  enum class Continuation: uint8_t {
+    None,       ///< nothing, the parser has to be restored to a save point
+    FirstChar,  ///< reading the first character of the document
+    Token       ///< parsing the token at which the parser stopped
+  };
+  Continuation continuation = Continuation::None;
 
   // Variables needed for safe/restore
   const char* lastTagStart = nullptr;
@@ -206,21 +249,54 @@ sergut::xml::detail::BasicPullParser<CharDecoder>::BasicPullParser(const sergut:
   : BasicPullParser(std::vector<char>(data.begin(), data.end()), 0)
 { }
 
+template<typename CharDecoder>
+sergut::xml::detail::BasicPullParser<CharDecoder>::BasicPullParser(const sergut::misc::ConstStringRef& data, const DataOwnership ownership)
+  : BasicPullParser(ownership == DataOwnership::Copy ? std::vector<char>(data.begin(), data.end()) : std::vector<char>(), 0)
+{
+  if(ownership == DataOwnership::Borrow) {
+    borrowedInputBegin = data.begin();
+    inputEnd = data.end();
+    readerState.readPointer = data.begin();
+    readFirstChar();
+  }
+}
+
 template<typename CharDecoder>
 sergut::xml::detail::BasicPullParser<CharDecoder>::BasicPullParser(std::vector<char>&& data, const std::size_t offset)
   : inputData(std::move(data))
-  , readerState(&*inputData.begin() + offset)
+  , inputEnd(inputData.data() + inputData.size())
+  , readerState(inputData.data() + offset)
 {
-  if(incompleteDocument) {
-    incompleteDocument = false;
-    nextChar();
+  readFirstChar();
+}
+
+template<typename CharDecoder>
+sergut::xml::detail::BasicPullParser<CharDecoder>::BasicPullParser(std::unique_ptr<const sergut::misc::MappedFile>&& file, const std::size_t offset)
+  : BasicPullParser(sergut::misc::ConstStringRef(file->begin() + offset, file->end()), DataOwnership::Borrow)
+{
+  mappedFile = std::move(file);
+}
+
+template<typename CharDecoder>
+sergut::xml::detail::BasicPullParser<CharDecoder>::BasicPullParser(std::vector<char>&& data, const std::size_t offset,
+                                                                  sergut::misc::InputSource& source, const std::size_t chunkSize)
+  : BasicPullParser(std::move(data), offset)
+{
+  inputSource = &source;
+  inputChunkSize = std::max<std::size_t>(chunkSize, 1);
+  compressionThreshold = inputChunkSize;
+  // read until the first character is complete
+  while(incompleteDocument && readFromInputSource()) {
+    readFirstChar();
   }
 }
 
 template<typename CharDecoder>
 std::vector<char>&& sergut::xml::detail::BasicPullParser<CharDecoder>::extractXmlData()
 {
+  takeOwnershipOfInput();
   incompleteDocument = true;
+  continuation = Continuation::None;
   return std::move(inputData);
 }
 
@@ -239,16 +315,73 @@ sergut::misc::ConstStringRef sergut::xml::detail::BasicPullParser<CharDecoder>::
 template<typename CharDecoder>
 sergut::misc::ConstStringRef sergut::xml::detail::BasicPullParser<CharDecoder>::getCurrentValue() const
 {
-  return sergut::misc::ConstStringRef(&*decodedValueBuffer.begin(), &*decodedValueBuffer.end());
+  return currentValue;
 }
 
 template<typename CharDecoder>
 void sergut::xml::detail::BasicPullParser<CharDecoder>::appendData(const char* data, const std::size_t size)
 {
-  compressInnerData();
+  takeOwnershipOfInput();
+  const Continuation pendingContinuation = incompleteDocument ? continuation : Continuation::None;
+  if(pendingContinuation != Continuation::None) {
+    // the parser is in the state before the incomplete token, which is complete
+    incompleteDocument = false;
+    continuation = Continuation::None;
+  }
+  compressInnerDataIfWorthwhile();
   const char* oldStartPos = inputData.data();
   inputData.insert(inputData.end(), data, data + size);
   recomputePointersToInput(oldStartPos);
+  inputEnd = inputData.data() + inputData.size();
+  if(pendingContinuation == Continuation::FirstChar) {
+    readFirstChar();
+  }
+}
+
+template<typename CharDecoder>
+void sergut::xml::detail::BasicPullParser<CharDecoder>::readFirstChar()
+{
+  incompleteDocument = false;
+  nextChar();
+  continuation = incompleteDocument ? Continuation::FirstChar : Continuation::None;
+}
+
+template<typename CharDecoder>
+void sergut::xml::detail::BasicPullParser<CharDecoder>::takeOwnershipOfInput()
+{
+  if(borrowedInputBegin == nullptr) {
+    return;
+  }
+  // all pointers into the input are relocated as if the input had been reallocated
+  inputData.assign(borrowedInputBegin, inputEnd);
+  inputEnd = inputData.data() + inputData.size();
+  recomputePointersToInput(borrowedInputBegin);
+  borrowedInputBegin = nullptr;
+  mappedFile.reset();
+}
+
+template<typename CharDecoder>
+void sergut::xml::detail::BasicPullParser<CharDecoder>::compressInnerDataIfWorthwhile()
+{
+  if(inputData.size() < compressionThreshold) {
+    return;
+  }
+  compressInnerData();
+  compressionThreshold = 2 * inputData.size() + inputChunkSize;
+}
+
+template<typename CharDecoder>
+bool sergut::xml::detail::BasicPullParser<CharDecoder>::readFromInputSource()
+{
+  compressInnerDataIfWorthwhile();
+  const std::size_t oldSize = inputData.size();
+  const char* oldStartPos = inputData.data();
+  inputData.resize(oldSize + inputChunkSize);
+  recomputePointersToInput(oldStartPos);
+  const std::size_t readSize = inputSource->read(inputData.data() + oldSize, inputChunkSize);
+  inputData.resize(oldSize + readSize);
+  inputEnd = inputData.data() + inputData.size();
+  return readSize != 0;
 }
 
 template<typename CharDecoder>
@@ -289,6 +422,7 @@ bool sergut::xml::detail::BasicPullParser<CharDecoder>::restoreToSavePoint()
   lastTagStart = innerStateSavePoint->readPointer;
   readerState.readPointer = lastTagStart;
   incompleteDocument = false;
+  continuation = Continuation::None;
 
   if(innerStateSavePoint->hasParseStackCopy()) {
     parseStack = std::move(innerStateSavePoint->parseStackCopy);
@@ -327,8 +461,8 @@ void sergut::xml::detail::BasicPullParser<CharDecoder>::compressInnerData()
   const char* storedReadPtrPos = innerStateSavePoint != nullptr ? innerStateSavePoint->readPointer : lastTagStart;
 
   const std::size_t reduceBy = storedReadPtrPos - inputData.data();
-  const std::size_t remainingDataSize = (&*inputData.end()) - storedReadPtrPos;
-  std::memcpy(inputData.data(), storedReadPtrPos, remainingDataSize);
+  const std::size_t remainingDataSize = inputData.data() + inputData.size() - storedReadPtrPos;
+  std::memmove(inputData.data(), storedReadPtrPos, remainingDataSize);
 
   if(innerStateSavePoint != nullptr) {
     innerStateSavePoint->readPointer -= reduceBy;
@@ -349,7 +483,9 @@ void sergut::xml::detail::BasicPullParser<CharDecoder>::recomputePointersToInput
     return;
   }
   const std::ptrdiff_t diff = inputData.data() - oldStartOfInput;
-  lastTagStart += diff;
+  if(lastTagStart != nullptr) {
+    lastTagStart += diff;
+  }
   readerState.readPointer += diff;
   if(innerStateSavePoint) {
     innerStateSavePoint->addOffset(diff);
@@ -369,7 +505,7 @@ inline
 bool sergut::xml::detail::BasicPullParser<CharDecoder>::nextChar()
 {
   const sergut::unicode::ParseResult parseResult =
-      CharDecoderT::parseNext(readerState.currentChar, readerState.readPointer, &*inputData.end());
+      CharDecoderT::parseNext(readerState.currentChar, readerState.readPointer, inputEnd);
   if(!sergut::unicode::isError(parseResult)) {
     readerState.readPointer += static_cast<int32_t>(parseResult);
     return true;
@@ -456,6 +592,7 @@ bool sergut::xml::detail::BasicPullParser<CharDecoder>::handleXmlDecl()
   if(!skipWhitespaces()) { return false; }
 
   while(parseAttribute(false)) {
+    if(!isOk()) { return false; }
     if(decodedNameBuffers.decodedAttrName == sergut::misc::ConstStringRef("version")) {
       const sergut::misc::ConstStringRef ver = getCurrentValue();
       if(ver.size() < 3 || ver[0] != '1' || ver[1] != '.') {
@@ -591,7 +728,8 @@ bool sergut::xml::detail::BasicPullParser<CharDecoder>::parseAttribute(const boo
       readerState.currentChar == '"' ? TextDecodingHelper<CharDecoder>::TextType::AttValueQuote
                                      : TextDecodingHelper<CharDecoder>::TextType::AttValueApos;
 
-  TextDecodingHelper<CharDecoder> helper(decodedValueBuffer, tt, readerState.readPointer, &*inputData.end());
+  TextDecodingHelper<CharDecoder> helper(decodedValueBuffer, tt, readerState.readPointer, inputEnd);
+  helper.allowVerbatimText();
   if(!helper.decodeText()) {
     if(helper.isError()) {
       currentTokenType = ParseTokenType::Error;
@@ -601,6 +739,7 @@ bool sergut::xml::detail::BasicPullParser<CharDecoder>::parseAttribute(const boo
     }
     return true;
   }
+  setCurrentValue(helper);
   readerState.readPointer = helper.getReadPointer();
   if(!nextChar()) { return true; }
   if(!skipWhitespaces()) { return true; }
@@ -621,7 +760,8 @@ bool sergut::xml::detail::BasicPullParser<CharDecoder>::parseText()
 
   TextDecodingHelper<CharDecoder> helper(decodedValueBuffer, TextDecodingHelper<CharDecoder>::TextType::CharData,
                                          readerState.readPointer - static_cast<std::size_t>(CharDecoder::encodeChar(readerState.currentChar)),
-                                         &*inputData.end());
+                                         inputEnd);
+  helper.allowVerbatimText();
   if(!helper.decodeText()) {
     if(helper.isIncomplete()) {
       incompleteDocument = true;
@@ -630,6 +770,7 @@ bool sergut::xml::detail::BasicPullParser<CharDecoder>::parseText()
     currentTokenType = ParseTokenType::Error;
     return true;
   }
+  setCurrentValue(helper);
   readerState.readPointer = helper.getEndOfTextPointer();
   if(!nextChar()) {
     return true;
@@ -638,6 +779,17 @@ bool sergut::xml::detail::BasicPullParser<CharDecoder>::parseText()
   return true;
 }
 
+template<typename CharDecoder>
+void sergut::xml::detail::BasicPullParser<CharDecoder>::setCurrentValue(const TextDecodingHelper<CharDecoder>& helper)
+{
+  currentValueInInputData = helper.isVerbatimText();
+  if(currentValueInInputData) {
+    currentValue = sergut::misc::ConstStringRef(helper.getStartOfTextPointer(), helper.getEndOfTextPointer());
+  } else {
+    currentValue = sergut::misc::ConstStringRef(decodedValueBuffer.data(), decodedValueBuffer.data() + decodedValueBuffer.size());
+  }
+}
+
 template<typename CharDecoder>
 bool sergut::xml::detail::BasicPullParser<CharDecoder>::parseCloseTag()
 {
@@ -691,6 +843,45 @@ bool sergut::xml::detail::BasicPullParser<CharDecoder>::parseCloseTag()
 
 template<typename CharDecoder>
 sergut::xml::ParseTokenType sergut::xml::detail::BasicPullParser<CharDecoder>::parseNext()
+{
+  if(incompleteDocument) {
+    return ParseTokenType::IncompleteDocument;
+  }
+  while(true) {
+    // The state before the token. If the token is incomplete, the parser
+    // returns to this state, such that the token is parsed again as soon as
+    // more data is available. Within one token, the only change to the parse
+    // stack is the pop of a closed tag.
+    const ParseTokenType tokenStartType = currentTokenType;
+    const ReaderState tokenStartReaderState = readerState;
+    const char* const tokenStartLastTagStart = lastTagStart;
+    const sergut::misc::ConstStringRef tokenStartValue = currentValue;
+    const bool tokenStartValueInInputData = currentValueInInputData;
+    const std::size_t tokenStartFrameCount = parseStack.frameCount();
+
+    parseNextToken();
+    if(!incompleteDocument || currentTokenType == ParseTokenType::Error) {
+      return getCurrentTokenType();
+    }
+    currentTokenType = tokenStartType;
+    readerState = tokenStartReaderState;
+    lastTagStart = tokenStartLastTagStart;
+    currentValue = tokenStartValue;
+    currentValueInInputData = tokenStartValueInInputData;
+    if(parseStack.frameCount() < tokenStartFrameCount) {
+      parseStack.restorePoppedData();
+    }
+    incompleteDocument = false;
+    if(inputSource == nullptr || !readFromInputSource()) {
+      incompleteDocument = true;
+      continuation = Continuation::Token;
+      return ParseTokenType::IncompleteDocument;
+    }
+  }
+}
+
+template<typename CharDecoder>
+sergut::xml::ParseTokenType sergut::xml::detail::BasicPullParser<CharDecoder>::parseNextToken()
 {
   if(incompleteDocument) {
     return ParseTokenType::IncompleteDocument;
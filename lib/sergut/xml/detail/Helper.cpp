@@ -0,0 +1,84 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "sergut/xml/detail/Helper.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace sergut {
+namespace xml {
+namespace detail {
+namespace Helper {
+
+namespace {
+struct CharRange {
+  sergut::unicode::Utf32Char first;
+  sergut::unicode::Utf32Char last;
+};
+
+// [4] NameStartChar ::=  ":" | [A-Z] | "_" | [a-z] | [#xC0-#xD6] | [#xD8-#xF6] | [#xF8-#x2FF] | [#x370-#x37D] |
+//                        [#x37F-#x1FFF] | [#x200C-#x200D] | [#x2070-#x218F] | [#x2C00-#x2FEF] | [#x3001-#xD7FF] |
+//                        [#xF900-#xFDCF] | [#xFDF0-#xFFFD] | [#x10000-#xEFFFF]
+// The characters beyond the BMP are handled by NameCharTable::classify()
+const CharRange nameStartCharRanges[] = {
+  { ':', ':' }, { 'A', 'Z' }, { '_', '_' }, { 'a', 'z' }, { 0xC0, 0xD6 }, { 0xD8, 0xF6 }, { 0xF8, 0x2FF },
+  { 0x370, 0x37D }, { 0x37F, 0x1FFF }, { 0x200C, 0x200D }, { 0x2070, 0x218F }, { 0x2C00, 0x2FEF },
+  { 0x3001, 0xD7FF }, { 0xF900, 0xFDCF }, { 0xFDF0, 0xFFFD }
+};
+
+// [4a] NameChar ::= NameStartChar | "-" | "." | [0-9] | #xB7 | [#x0300-#x036F] | [#x203F-#x2040]
+const CharRange additionalNameCharRanges[] = {
+  { '-', '-' }, { '.', '.' }, { '0', '9' }, { 0xB7, 0xB7 }, { 0x300, 0x36F }, { 0x203F, 0x2040 }
+};
+}
+
+NameCharTable::NameCharTable()
+{
+  std::vector<uint8_t> classes(0x10000, 0);
+  for(const CharRange& range: nameStartCharRanges) {
+    std::fill(classes.begin() + range.first, classes.begin() + range.last + 1, NameCharBit | NameStartCharBit);
+  }
+  for(const CharRange& range: additionalNameCharRanges) {
+    std::fill(classes.begin() + range.first, classes.begin() + range.last + 1, NameCharBit);
+  }
+  std::copy(classes.begin(), classes.begin() + sizeof(asciiClasses), asciiClasses);
+
+  // most pages are either completely in or out of the ranges, thus only few distinct pages remain
+  for(std::size_t page = 0; page < sizeof(pageIndex); ++page) {
+    const uint8_t* pageData = classes.data() + page * 256;
+    std::size_t index = 0;
+    while(index * 256 < pages.size() && std::memcmp(pages.data() + index * 256, pageData, 256) != 0) {
+      ++index;
+    }
+    if(index * 256 == pages.size()) {
+      pages.insert(pages.end(), pageData, pageData + 256);
+    }
+    pageIndex[page] = static_cast<uint8_t>(index);
+  }
+}
+
+const NameCharTable nameCharTable;
+
+}
+}
+}
+}
@@ -23,43 +23,69 @@
 
 #include "sergut/unicode/Utf32Char.h"
 
+#include <cstdint>
+#include <vector>
+
 namespace sergut {
 namespace xml {
 namespace detail {
 namespace Helper {
+
+/// The bits of the classification of a name character
+enum NameCharClass: uint8_t {
+  NameCharBit      = 0x1, ///< [4a] NameChar
+  NameStartCharBit = 0x2  ///< [4] NameStartChar
+};
+
+/**
+ * \brief Lookup tables for the classification of the characters in names
+ *
+ * ASCII characters are looked up in a table with 128 entries, the other
+ * characters of the BMP in a two level table of pages with 256 characters,
+ * where the pages with the same content are shared. All characters beyond
+ * the BMP up to 0xEFFFF are NameStartChars.
+ */
+class NameCharTable {
+public:
+  NameCharTable();
+
+  /// \brief Return the \c NameCharClass bits of \c chr
+  uint8_t classify(const sergut::unicode::Utf32Char chr) const {
+    if(chr < 0x80) {
+      return asciiClasses[chr];
+    }
+    if(chr <= 0xFFFF) {
+      return pages[std::size_t(pageIndex[chr >> 8]) * 256 + (chr & 0xFF)];
+    }
+    return chr <= 0xEFFFF ? (NameCharBit | NameStartCharBit) : 0;
+  }
+
+private:
+  uint8_t asciiClasses[128];
+  uint8_t pageIndex[256];
+  std::vector<uint8_t> pages;
+};
+
+extern const NameCharTable nameCharTable;
+
 inline
 bool isNameStartChar(sergut::unicode::Utf32Char chr) {
-  if('a' <= chr && chr <= 'z') return true;
-  if('A' <= chr && chr <= 'Z') return true;
-  if(chr == ':' || chr == '_') return true;
-  if(0xC0 <= chr && chr <= 0xD6) return true;
-  if(0xD8 <= chr && chr <= 0xF6) return true;
-  if(0xF8 <= chr && chr <= 0x2FF) return true;
-  if(0x370 <= chr && chr <= 0x37D) return true;
-  if(0x37F <= chr && chr <= 0x1FFF) return true;
-  if(0x200C <= chr && chr <= 0x200D) return true;
-  if(0x2070 <= chr && chr <= 0x218F) return true;
-  if(0x2C00 <= chr && chr <= 0x2FEF) return true;
-  if(0x3001 <= chr && chr <= 0xD7FF) return true;
-  if(0xF900 <= chr && chr <= 0xFDCF) return true;
-  if(0xFDF0 <= chr && chr <= 0xFFFD) return true;
-  if(0x10000 <= chr && chr <= 0xEFFFF) return true;
   // [4] NameStartChar ::=  ":" | [A-Z] | "_" | [a-z] | [#xC0-#xD6] | [#xD8-#xF6] | [#xF8-#x2FF] | [#x370-#x37D] |
   //                        [#x37F-#x1FFF] | [#x200C-#x200D] | [#x2070-#x218F] | [#x2C00-#x2FEF] | [#x3001-#xD7FF] |
   //                        [#xF900-#xFDCF] | [#xFDF0-#xFFFD] | [#x10000-#xEFFFF]
-  return false;
+  return (nameCharTable.classify(chr) & NameStartCharBit) != 0;
 }
 
 inline
 bool isNameChar(sergut::unicode::Utf32Char chr) {
-  if(isNameStartChar(chr)) return true;
-  if('0' <= chr && chr <= '9') return true;
-  if(chr == '-' || chr == '.') return true;
-  if(chr == 0xB7) return true;
-  if(0x300 <= chr && chr <= 0x36F) return true;
-  if(0x203F <= chr && chr <= 0x2040) return true;
   // [4a] NameChar ::= NameStartChar | "-" | "." | [0-9] | #xB7 | [#x0300-#x036F] | [#x203F-#x2040]
-  return false;
+  return (nameCharTable.classify(chr) & NameCharBit) != 0;
+}
+
+/// The ASCII subset of NameChar, to check single bytes of UTF-8 encoded names
+inline
+bool isAsciiNameChar(const char c) {
+  return static_cast<unsigned char>(c) < 0x80 && isNameChar(static_cast<unsigned char>(c));
 }
 
 inline
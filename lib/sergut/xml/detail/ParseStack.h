@@ -48,9 +48,15 @@ public:
   }
 
   void popData() {
+    poppedFrameEnd = frameEnd.back();
     frameEnd.pop_back();
   }
 
+  /// Undo the last \c popData(), valid as long as no data has been pushed since
+  void restorePoppedData() {
+    frameEnd.push_back(poppedFrameEnd);
+  }
+
   std::size_t getTopFrameSize() const noexcept {
     if(buffer.empty()) { return 0; }
     return getTopFrameEnd() - getTopFrameStart();
@@ -95,6 +101,7 @@ private:
 private:
   std::vector<char> buffer;
   std::vector<std::size_t> frameEnd;
+  std::size_t poppedFrameEnd = 0;
 };
 
 template<>
@@ -110,9 +117,15 @@ public:
   }
 
   void popData() {
+    poppedFrame = frames.back();
     frames.pop_back();
   }
 
+  /// Undo the last \c popData(), valid as long as no data has been pushed since
+  void restorePoppedData() {
+    frames.push_back(poppedFrame);
+  }
+
   const sergut::misc::ConstStringRef getTopData() const noexcept {
     if(frames.empty()) {
       return sergut::misc::ConstStringRef();
@@ -135,6 +148,7 @@ public:
 
 private:
   std::vector<sergut::misc::ConstStringRef> frames;
+  sergut::misc::ConstStringRef poppedFrame;
 };
 
 }
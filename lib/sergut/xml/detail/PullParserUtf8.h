@@ -34,11 +34,63 @@ class PullParserUtf8: public BasicPullParser<sergut::unicode::Utf8Codec>
   using BasicPullParser<sergut::unicode::Utf8Codec>::BasicPullParser;
 };
 
+template<>
+inline
+bool BasicPullParser<sergut::unicode::Utf8Codec>::nextChar()
+{
+  const char* const endOfInput = inputEnd;
+  // ASCII characters don't need to be decoded
+  if(readerState.readPointer != endOfInput && sergut::unicode::Utf8Codec::isAscii(*readerState.readPointer)) {
+    readerState.currentChar = *readerState.readPointer;
+    ++readerState.readPointer;
+    return true;
+  }
+  const sergut::unicode::ParseResult parseResult =
+      sergut::unicode::Utf8Codec::parseNext(readerState.currentChar, readerState.readPointer, endOfInput);
+  if(!sergut::unicode::isError(parseResult)) {
+    readerState.readPointer += static_cast<int32_t>(parseResult);
+    return true;
+  }
+  switch (parseResult) {
+  case sergut::unicode::ParseResult::IncompleteCharacter:
+    incompleteDocument = true;
+    return false;
+  case sergut::unicode::ParseResult::InvalidCharacter:
+    currentTokenType = ParseTokenType::Error;
+    return false;
+  }
+  assert(false);
+}
+
+template<>
+inline
+bool BasicPullParser<sergut::unicode::Utf8Codec>::skipWhitespaces()
+{
+  if(!std::isspace(readerState.currentChar)) {
+    return isOk();
+  }
+  // whitespace is always ASCII, so the bytes can be skipped without decoding them
+  const char* const endOfInput = inputEnd;
+  const char* whitespaceEnd = readerState.readPointer;
+  while(whitespaceEnd != endOfInput && std::isspace(static_cast<unsigned char>(*whitespaceEnd))) {
+    ++whitespaceEnd;
+  }
+  if(whitespaceEnd == endOfInput) {
+    // the current char stays a whitespace, just like with nextChar()
+    readerState.readPointer = whitespaceEnd;
+    incompleteDocument = true;
+    return isOk();
+  }
+  readerState.readPointer = whitespaceEnd;
+  nextChar();
+  return isOk();
+}
+
 template<>
 inline
 bool BasicPullParser<sergut::unicode::Utf8Codec>::nextAsciiChar()
 {
-  if(readerState.readPointer == &*inputData.end()) {
+  if(readerState.readPointer == inputEnd) {
     incompleteDocument = true;
     return false;
   }
@@ -52,6 +104,7 @@ bool BasicPullParser<sergut::unicode::Utf8Codec>::nextAsciiChar()
 }
 
 template<>
+inline
 bool BasicPullParser<sergut::unicode::Utf8Codec>::parseName(const NameType nameType)
 {
   // [4] NameStartChar ::=  ":" | [A-Z] | "_" | [a-z] | [#xC0-#xD6] | [#xD8-#xF6] | [#xF8-#x2FF] | [#x370-#x37D] |
@@ -60,18 +113,24 @@ bool BasicPullParser<sergut::unicode::Utf8Codec>::parseName(const NameType nameT
   // [4a] NameChar ::= NameStartChar | "-" | "." | [0-9] | #xB7 | [#x0300-#x036F] | [#x203F-#x2040]
   if(!Helper::isNameStartChar(readerState.currentChar)) return false;
   const char* startOfName = readerState.readPointer - std::size_t(sergut::unicode::Utf8Codec::encodeChar(readerState.currentChar));
-  if(!nextChar()) return true;
-  while(Helper::isNameChar(readerState.currentChar)) {
+  const char* const endOfInput = inputEnd;
+  do {
+    // most names are pure ASCII, their bytes are checked without decoding them
+    const char* asciiNameEnd = readerState.readPointer;
+    while(asciiNameEnd != endOfInput && Helper::isAsciiNameChar(*asciiNameEnd)) {
+      ++asciiNameEnd;
+    }
+    readerState.readPointer = asciiNameEnd;
     if(!nextChar()) return true;
-  }
+  } while(Helper::isNameChar(readerState.currentChar));
+  // the current char is the first one after the name, it is not necessarily valid at this position
+  const char* endOfName = readerState.readPointer - std::size_t(sergut::unicode::Utf8Codec::encodeChar(readerState.currentChar));
   switch(nameType) {
   case NameType::Tag:
-    // here it is OK to subtract 1 from readPointer, as we know the only possible chars are '>' or 0x9, 0xA, 0xD, 0x20
-    decodedNameBuffers.decodedTagName = sergut::misc::ConstStringRef(startOfName, readerState.readPointer - 1);
+    decodedNameBuffers.decodedTagName = sergut::misc::ConstStringRef(startOfName, endOfName);
     return true;
   case NameType::Attribute:
-    // here it is OK to subtract 1 from readPointer, as we know the only possible chars are '=' or 0x9, 0xA, 0xD, 0x20
-    decodedNameBuffers.decodedAttrName = sergut::misc::ConstStringRef(startOfName, readerState.readPointer - 1);
+    decodedNameBuffers.decodedAttrName = sergut::misc::ConstStringRef(startOfName, endOfName);
     return true;
   }
   assert(false);
@@ -81,7 +140,7 @@ bool BasicPullParser<sergut::unicode::Utf8Codec>::parseName(const NameType nameT
 inline
 std::size_t moveNReturnOffset(sergut::misc::ConstStringRef& ref, char* lastDataEnd) {
   sergut::misc::ConstStringRef orig = ref;
-  std::memcpy(lastDataEnd, orig.begin(), orig.size());
+  std::memmove(lastDataEnd, orig.begin(), orig.size());
   char* const newEnd = lastDataEnd + orig.size();
   const sergut::misc::ConstStringRef newPos(lastDataEnd, newEnd);
   ref = newPos;
@@ -95,10 +154,15 @@ void sergut::xml::detail::BasicPullParser<sergut::unicode::Utf8Codec>::recompute
     return;
   }
   const std::ptrdiff_t diff = inputData.data() - oldStartOfInput;
-  lastTagStart += diff;
+  if(lastTagStart != nullptr) {
+    lastTagStart += diff;
+  }
   readerState.readPointer += diff;
   parseStack.addOffset(diff);
   decodedNameBuffers.addOffset(diff);
+  if(currentValueInInputData) {
+    currentValue.addOffset(diff);
+  }
   if(innerStateSavePoint) {
     innerStateSavePoint->addOffset(diff);
   }
@@ -202,8 +266,21 @@ void sergut::xml::detail::BasicPullParser<sergut::unicode::Utf8Codec>::compressI
       return;
     }
   }
-  const std::size_t remaining = &*inputData.end() - (writePointer + offset);
-  std::memcpy(writePointer, writePointer + offset, remaining);
+  if(currentValueInInputData) {
+    // the value of the current attribute or text is behind the innermost tag name,
+    // the values of other tokens may be dropped
+    if(currentTokenType == ParseTokenType::Attribute || currentTokenType == ParseTokenType::Text) {
+      currentValue.addOffset(-offset);
+    } else {
+      currentValue = sergut::misc::ConstStringRef();
+      currentValueInInputData = false;
+    }
+  }
+  const std::size_t remaining = inputData.data() + inputData.size() - (writePointer + offset);
+  if(remaining != 0) {
+    // the remaining data overlaps with its new position
+    std::memmove(writePointer, writePointer + offset, remaining);
+  }
   lastTagStart -= offset;
   readerState.readPointer -= offset;
 
@@ -0,0 +1,145 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "sergut/xml/detail/RecordedPullParser.h"
+
+sergut::xml::detail::RecordedPullParser::RecordedPullParser(PullParser& pSourceParser)
+  : sergut::xml::PullParser()
+  , sourceParser(pSourceParser)
+{ }
+
+sergut::xml::ParseTokenType sergut::xml::detail::RecordedPullParser::recordElement()
+{
+  if(recordingComplete) {
+    return sourceParser.getCurrentTokenType();
+  }
+  if(tokens.empty()) {
+    if(sourceParser.getCurrentTokenType() != ParseTokenType::OpenTag) {
+      return ParseTokenType::Error;
+    }
+    recordCurrentToken();
+    openTagCount = 1;
+  }
+  while(true) {
+    const ParseTokenType tokenType = sourceParser.parseNext();
+    if(!xml::isOk(tokenType)) {
+      return tokenType;
+    }
+    if(openTagCount == 0 && tokenType != ParseTokenType::Text) {
+      // the token after the element is not recorded, the source parser stays on it
+      recordingComplete = true;
+      return tokenType;
+    }
+    recordCurrentToken();
+    if(tokenType == ParseTokenType::OpenTag) {
+      ++openTagCount;
+    } else if(tokenType == ParseTokenType::CloseTag) {
+      --openTagCount;
+    }
+  }
+}
+
+void sergut::xml::detail::RecordedPullParser::clear()
+{
+  tokens.clear();
+  recordedData.clear();
+  openTagCount = 0;
+  recordingComplete = false;
+  replayIndex = 0;
+}
+
+sergut::xml::ParseTokenType sergut::xml::detail::RecordedPullParser::parseNext()
+{
+  if(!isReplaying()) {
+    return sourceParser.parseNext();
+  }
+  ++replayIndex;
+  return getCurrentTokenType();
+}
+
+sergut::xml::ParseTokenType sergut::xml::detail::RecordedPullParser::getCurrentTokenType() const
+{
+  if(!isReplaying()) {
+    return sourceParser.getCurrentTokenType();
+  }
+  return tokens[replayIndex].tokenType;
+}
+
+sergut::misc::ConstStringRef sergut::xml::detail::RecordedPullParser::getCurrentTagName() const
+{
+  if(!isReplaying()) {
+    return sourceParser.getCurrentTagName();
+  }
+  return sergut::misc::ConstStringRef(recordedData.data() + getTokenStart(), recordedData.data() + tokens[replayIndex].tagNameEnd);
+}
+
+sergut::misc::ConstStringRef sergut::xml::detail::RecordedPullParser::getCurrentAttributeName() const
+{
+  if(!isReplaying()) {
+    return sourceParser.getCurrentAttributeName();
+  }
+  const RecordedToken& token = tokens[replayIndex];
+  return sergut::misc::ConstStringRef(recordedData.data() + token.tagNameEnd, recordedData.data() + token.attributeNameEnd);
+}
+
+sergut::misc::ConstStringRef sergut::xml::detail::RecordedPullParser::getCurrentValue() const
+{
+  if(!isReplaying()) {
+    return sourceParser.getCurrentValue();
+  }
+  const RecordedToken& token = tokens[replayIndex];
+  return sergut::misc::ConstStringRef(recordedData.data() + token.attributeNameEnd, recordedData.data() + token.valueEnd);
+}
+
+bool sergut::xml::detail::RecordedPullParser::setSavePointAtCurrentTag()
+{
+  if(isReplaying()) {
+    // save points within the recorded element are not supported
+    return false;
+  }
+  return sourceParser.setSavePointAtCurrentTag();
+}
+
+bool sergut::xml::detail::RecordedPullParser::restoreToSavePoint()
+{
+  if(isReplaying()) {
+    return false;
+  }
+  return sourceParser.restoreToSavePoint();
+}
+
+void sergut::xml::detail::RecordedPullParser::recordCurrentToken()
+{
+  const ParseTokenType tokenType = sourceParser.getCurrentTokenType();
+  const sergut::misc::ConstStringRef tagName = sourceParser.getCurrentTagName();
+  recordedData.insert(recordedData.end(), tagName.begin(), tagName.end());
+  const std::size_t tagNameEnd = recordedData.size();
+  if(tokenType == ParseTokenType::Attribute) {
+    const sergut::misc::ConstStringRef attributeName = sourceParser.getCurrentAttributeName();
+    recordedData.insert(recordedData.end(), attributeName.begin(), attributeName.end());
+  }
+  const std::size_t attributeNameEnd = recordedData.size();
+  if(tokenType == ParseTokenType::Attribute || tokenType == ParseTokenType::Text) {
+    const sergut::misc::ConstStringRef value = sourceParser.getCurrentValue();
+    recordedData.insert(recordedData.end(), value.begin(), value.end());
+  }
+  tokens.push_back(RecordedToken{tokenType, tagNameEnd, attributeNameEnd, recordedData.size()});
+}
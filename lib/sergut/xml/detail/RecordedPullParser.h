@@ -0,0 +1,97 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "sergut/xml/PullParser.h"
+
+#include <vector>
+
+namespace sergut {
+namespace xml {
+namespace detail {
+
+/**
+ * \brief The RecordedPullParser class records the tokens of an element out of
+ *        another \c PullParser and replays them afterwards
+ *
+ * The recording can be interrupted when the other parser runs out of data
+ * and continues with the token at which it stopped. After the tokens of the
+ * element have been replayed, the RecordedPullParser passes on the tokens of
+ * the other parser.
+ */
+class RecordedPullParser: public PullParser
+{
+public:
+  RecordedPullParser(PullParser& pSourceParser);
+
+  /**
+   * \brief Record the element at whose opening tag the source parser is
+   *        positioned, including the text that follows it
+   *
+   * \return \c IncompleteDocument if the source parser needs more data, after
+   *         appending it, \c recordElement() has to be called again.
+   *         \c Error if the source parser is not on an opening tag or has
+   *         failed. Otherwise the type of the first token after the element,
+   *         at which the source parser now stands.
+   */
+  ParseTokenType recordElement();
+  /// \brief Start the replay at the opening tag of the recorded element
+  void startReplay() { replayIndex = 0; }
+  /// \brief Drop the recorded tokens to record the next element
+  void clear();
+
+  std::vector<char>&& extractXmlData() override { return sourceParser.extractXmlData(); }
+  ParseTokenType parseNext() override;
+  ParseTokenType getCurrentTokenType() const override;
+  sergut::misc::ConstStringRef getCurrentTagName() const override;
+  sergut::misc::ConstStringRef getCurrentAttributeName() const override;
+  sergut::misc::ConstStringRef getCurrentValue() const override;
+  void appendData(const char* data, const std::size_t size) override { sourceParser.appendData(data, size); }
+  bool setSavePointAtCurrentTag() override;
+  bool restoreToSavePoint() override;
+
+private:
+  /// The token with the offsets of its strings in recordedData
+  struct RecordedToken {
+    ParseTokenType tokenType;
+    std::size_t tagNameEnd;
+    std::size_t attributeNameEnd;
+    std::size_t valueEnd;
+  };
+
+  void recordCurrentToken();
+  bool isReplaying() const { return recordingComplete && replayIndex < tokens.size(); }
+  std::size_t getTokenStart() const { return replayIndex == 0 ? 0 : tokens[replayIndex - 1].valueEnd; }
+
+private:
+  PullParser& sourceParser;
+  std::vector<RecordedToken> tokens;
+  /// the tag names, attribute names, and values of all tokens one after the other
+  std::vector<char> recordedData;
+  std::size_t openTagCount = 0;
+  bool recordingComplete = false;
+  std::size_t replayIndex = 0;
+};
+
+}
+}
+}
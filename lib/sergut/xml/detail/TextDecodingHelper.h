@@ -21,12 +21,15 @@
 
 #pragma once
 
+#include "sergut/misc/EscapeScanner.h"
 #include "sergut/unicode/ParseResult.h"
 #include "sergut/unicode/Utf8Codec.h"
 #include "sergut/unicode/Utf32Char.h"
 #include "sergut/xml/detail/Helper.h"
 
 #include <cassert>
+#include <cstring>
+#include <type_traits>
 
 namespace sergut {
 namespace xml {
@@ -55,6 +58,14 @@ public:
   { }
 
   bool decodeText();
+  /// \brief Don't copy text, that contains no references, to the decoded text buffer
+  ///
+  /// This is only supported for UTF-8, where such a text is equal to its
+  /// input. After decoding check \c isVerbatimText() and use the input between
+  /// \c getStartOfTextPointer() and \c getEndOfTextPointer() in that case.
+  void allowVerbatimText() { verbatimText = std::is_same<CharDecoder, sergut::unicode::Utf8Codec>::value; }
+  /// \brief Return whether the text was not copied as it needs no decoding
+  bool isVerbatimText() const { return verbatimText; }
   bool isError() const { return currentTokenType == DecodingType::Error; }
   bool isIncomplete() const { return currentTokenType == DecodingType::IncompleteText; }
   std::size_t getReadCount() const { return readPointer - originalReadPointer; }
@@ -65,6 +76,8 @@ public:
   std::size_t getWriteCount() const { return writePointer - decodedTextBuffer.data(); }
 
 private:
+  bool copyPlainText();
+  bool copyVerbatimText(const char* verbatimTextEnd);
   bool nextChar();
   bool nextAsciiChar();
   bool handleEntity(sergut::unicode::Utf32Char* decodedCharRef);
@@ -84,6 +97,8 @@ private:
   std::vector<char>& decodedTextBuffer;
   char* writePointer;
   TextType textType;
+  /// as long as this is set, nothing is written to decodedTextBuffer
+  bool verbatimText = false;
 };
 
 } // namespace detail
@@ -100,6 +115,11 @@ bool sergut::xml::detail::TextDecodingHelper<CharDecoder>::decodeText()
     currentTokenType = (textType == TextType::Plain) ? DecodingType::AtEnd : DecodingType::IncompleteText;
   }
   while(currentTokenType == DecodingType::Parsing) {
+    if(!copyPlainText()) { return false; }
+    if(readPointer == readPointerEnd) {
+      currentTokenType = (textType == TextType::Plain) ? DecodingType::AtEnd : DecodingType::IncompleteText;
+      break;
+    }
     if(!nextChar()) { return false; }
 
     checkForEndChar();
@@ -115,6 +135,10 @@ bool sergut::xml::detail::TextDecodingHelper<CharDecoder>::decodeText()
     }
     sergut::unicode::Utf32Char chr;
     if(currentChar == '&') {
+      // the text differs from the input from here on
+      if(verbatimText && !copyVerbatimText(readPointer - 1)) {
+        return false;
+      }
       if(!handleEntity(&chr)) {
         return false;
       }
@@ -125,7 +149,7 @@ bool sergut::xml::detail::TextDecodingHelper<CharDecoder>::decodeText()
       currentTokenType = DecodingType::Error;
       return false;
     }
-    if(!writeChar(chr)) {
+    if(!verbatimText && !writeChar(chr)) {
       return false;
     }
     if(readPointer == readPointerEnd) {
@@ -137,6 +161,77 @@ bool sergut::xml::detail::TextDecodingHelper<CharDecoder>::decodeText()
   return currentTokenType == DecodingType::AtEnd;
 }
 
+template<typename CharDecoder>
+inline
+bool sergut::xml::detail::TextDecodingHelper<CharDecoder>::copyPlainText()
+{
+  // only UTF-8 text can be copied without decoding it
+  return true;
+}
+
+// optimization for UTF-8
+namespace sergut {
+namespace xml {
+namespace detail {
+template<>
+inline
+bool TextDecodingHelper<sergut::unicode::Utf8Codec>::copyPlainText()
+{
+  // Copy the run of ASCII characters up to the next byte that has to be
+  // looked at by the per character decoding in one go
+  const char quoteChar = textType == TextType::AttValueApos  ? '\''
+                       : textType == TextType::AttValueQuote ? '"'
+                                                             : '<';
+  const char* plainTextEnd = sergut::misc::EscapeScanner::findXmlTextSpecial(readPointer, readPointerEnd, quoteChar);
+  const std::size_t plainTextSize = plainTextEnd - readPointer;
+  if(plainTextSize == 0) {
+    return true;
+  }
+  if(verbatimText) {
+    readPointer = plainTextEnd;
+    currentChar = plainTextEnd[-1];
+    return true;
+  }
+  const std::size_t writePointerOffset = writePointer - decodedTextBuffer.data();
+  if(decodedTextBuffer.size() - writePointerOffset < plainTextSize) {
+    try {
+      decodedTextBuffer.resize(writePointerOffset + plainTextSize + 50);
+    } catch(const std::exception&) {
+      currentTokenType = DecodingType::Error;
+      return false;
+    }
+    writePointer = decodedTextBuffer.data() + writePointerOffset;
+  }
+  std::memcpy(writePointer, readPointer, plainTextSize);
+  writePointer += plainTextSize;
+  readPointer = plainTextEnd;
+  currentChar = plainTextEnd[-1];
+  return true;
+}
+}
+}
+}
+
+template<typename CharDecoder>
+inline
+bool sergut::xml::detail::TextDecodingHelper<CharDecoder>::copyVerbatimText(const char* verbatimTextEnd)
+{
+  // only used for UTF-8, thus the input can be copied as it is
+  const std::size_t verbatimTextSize = verbatimTextEnd - originalReadPointer;
+  try {
+    if(decodedTextBuffer.size() < verbatimTextSize + 4) {
+      decodedTextBuffer.resize(verbatimTextSize + 50);
+    }
+  } catch(const std::exception&) {
+    currentTokenType = DecodingType::Error;
+    return false;
+  }
+  std::memcpy(decodedTextBuffer.data(), originalReadPointer, verbatimTextSize);
+  writePointer = decodedTextBuffer.data() + verbatimTextSize;
+  verbatimText = false;
+  return true;
+}
+
 template<typename CharDecoder>
 inline
 bool sergut::xml::detail::TextDecodingHelper<CharDecoder>::nextChar()
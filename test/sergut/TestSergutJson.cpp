@@ -7,7 +7,10 @@
 
 #include <rapidjson/document.h>
 
-
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -94,6 +97,14 @@ TEST_CASE("Serialize complex class to JSON", "[sergut]")
         CHECK(tp == tst);
       }
     }
+    WHEN("The datastructure is deserialized from JSON in place") {
+      sergut::JsonDeserializer ser(std::vector<char>(req.begin(), req.end()));
+      TestParent tst = ser.deserializeData<TestParent>();
+
+      THEN("The result is the specified datastructure") {
+        CHECK(tp == tst);
+      }
+    }
   }
 }
 
@@ -153,3 +164,354 @@ TEST_CASE("Test some functions", "[sergut]") {
     }
   }
 }
+
+TEST_CASE("Serialize JSON into sinks", "[sergut]") {
+  GIVEN("A JTC1")  {
+    JTC1 tp;
+    tp.path="/home/";
+    const std::string req = "{\"path\":\"/home/\",\"active\":1}";
+    WHEN("The result is taken out of the serializer") {
+      sergut::JsonSerializer ser;
+      ser.serializeData(tp);
+      const std::string result = ser.take();
+
+      THEN("The result is the specified string and the serializer is empty") {
+        CHECK(result == req);
+        CHECK(ser.str() == "");
+      }
+    }
+    WHEN("The datastructure is serialized into a caller provided string") {
+      std::string result = "prefix:";
+      {
+        sergut::misc::StringSink sink(result);
+        sergut::JsonSerializer ser(sink);
+        ser.serializeData(tp);
+        ser.flush();
+      }
+
+      THEN("The result is appended to the string") {
+        CHECK(result == "prefix:" + req);
+      }
+    }
+    WHEN("The datastructure is serialized into a caller provided vector") {
+      std::vector<char> result;
+      sergut::misc::VectorSink sink(result);
+      sergut::JsonSerializer ser(sink);
+      ser.serializeData(tp);
+      ser.flush();
+
+      THEN("The vector contains the specified string") {
+        CHECK(std::string(result.begin(), result.end()) == req);
+      }
+    }
+    WHEN("The datastructure is serialized into a callback") {
+      std::string result;
+      sergut::misc::CallbackSink sink([&result](const char* data, std::size_t size) { result.append(data, size); });
+      sergut::JsonSerializer ser(sink);
+      ser.serializeData(tp);
+      ser.flush();
+
+      THEN("The callback received the specified string") {
+        CHECK(result == req);
+      }
+    }
+  }
+}
+
+TEST_CASE("Stream JSON with bounded memory", "[sergut]") {
+  GIVEN("A large collection") {
+    std::vector<int> data(10000, 4711);
+    std::string req = "[";
+    for(std::size_t i = 0; i < data.size(); ++i) {
+      req += i == 0 ? "4711" : ",4711";
+    }
+    req += "]";
+    WHEN("The collection is streamed into a callback with a small buffer") {
+      const std::size_t bufferSize = 1000;
+      std::string result;
+      std::size_t maxChunkSize = 0;
+      sergut::misc::CallbackSink sink([&](const char* data, std::size_t size) {
+        result.append(data, size);
+        maxChunkSize = std::max(maxChunkSize, size);
+      }, bufferSize);
+      sergut::JsonSerializer ser(sink);
+      ser.serializeData(data);
+
+      THEN("The data is handed over in chunks while serializing") {
+        CHECK(result.size() > req.size() - bufferSize);
+        CHECK(maxChunkSize <= bufferSize);
+        ser.flush();
+        CHECK(result == req);
+      }
+    }
+    WHEN("The collection is streamed into a file descriptor") {
+      std::FILE* file = std::tmpfile();
+      REQUIRE(file != nullptr);
+      {
+        sergut::misc::FileDescriptorSink sink(fileno(file), 1000);
+        sergut::JsonSerializer ser(sink);
+        ser.serializeData(data);
+        ser.flush();
+      }
+
+      THEN("The file contains the specified string") {
+        std::rewind(file);
+        std::string result(req.size() + 1, '\0');
+        result.resize(std::fread(&result[0], 1, result.size(), file));
+        std::fclose(file);
+        CHECK(result == req);
+      }
+    }
+  }
+}
+
+struct JTC2 {
+  int first = 1;
+  bool withOptional = false;
+  int optional = 2;
+  int last = 3;
+};
+
+SERGUT_FUNCTION(JTC2, data, ar) {
+  ar & SERGUT_MMEMBER(data, first);
+  if(data.withOptional) {
+    ar & SERGUT_MMEMBER(data, optional);
+  }
+  ar & SERGUT_MMEMBER(data, last);
+}
+
+TEST_CASE("Serialize repeated and conditional members to JSON", "[sergut]") {
+  GIVEN("A vector of structs that skip members depending on their data") {
+    std::vector<JTC2> data(4);
+    data[1].withOptional = true;
+    data[3].withOptional = true;
+    WHEN("The vector is serialized twice") {
+      sergut::JsonSerializer ser1;
+      ser1.serializeData(data);
+      sergut::JsonSerializer ser2;
+      ser2.serializeData(data);
+
+      THEN("The keys match the serialized members") {
+        const std::string req = "[{\"first\":1,\"last\":3},{\"first\":1,\"optional\":2,\"last\":3},"
+                                "{\"first\":1,\"last\":3},{\"first\":1,\"optional\":2,\"last\":3}]";
+        CHECK(ser1.str() == req);
+        CHECK(ser2.str() == req);
+      }
+    }
+  }
+}
+
+TEST_CASE("Reuse JsonSerializer", "[sergut]") {
+  GIVEN("A JsonSerializer that has already been used") {
+    JTC1 tp;
+    tp.path="/home/";
+    sergut::JsonSerializer ser;
+    ser.serializeData(tp);
+    WHEN("The serializer is reset and used again") {
+      const std::size_t capacity = ser.data().capacity();
+      ser.reset();
+      CHECK(ser.data() == "");
+      tp.active = false;
+      ser.serializeData(tp);
+
+      THEN("Only the new data is contained and the buffer is kept") {
+        CHECK(ser.data() == "{\"path\":\"/home/\",\"active\":0}");
+        CHECK(ser.data().capacity() == capacity);
+      }
+    }
+  }
+}
+
+struct JTC3 {
+  int value;
+  std::vector<int> values;
+};
+
+SERGUT_FUNCTION(JTC3, data, ar) {
+  if(data.value < 0) {
+    throw std::invalid_argument("negative value");
+  }
+  ar & SERGUT_MMEMBER(data, value)
+      & SERGUT_MMEMBER(data, values);
+}
+
+TEST_CASE("Serialize JSON collections in parallel", "[sergut]") {
+  GIVEN("A large vector of structs") {
+    std::vector<JTC3> data;
+    for(int i = 0; i < 1000; ++i) {
+      data.push_back(JTC3{i, std::vector<int>(i % 5, i)});
+    }
+    sergut::misc::ThreadPool pool(3);
+    WHEN("The vector is serialized in parallel") {
+      sergut::JsonSerializer ser;
+      ser.setThreadPool(&pool, 64);
+      ser.serializeData(data);
+      sergut::JsonSerializer sequentialSer;
+      sequentialSer.serializeData(data);
+
+      THEN("The result is the same as the sequential one") {
+        CHECK(ser.str() == sequentialSer.str());
+      }
+    }
+    WHEN("Serializing an element fails") {
+      data[500].value = -1;
+      sergut::JsonSerializer ser;
+      ser.setThreadPool(&pool, 64);
+
+      THEN("The exception is passed on") {
+        CHECK_THROWS_AS(ser.serializeData(data), std::invalid_argument);
+      }
+    }
+  }
+}
+
+TEST_CASE("Deserialize large JSON arrays", "[sergut]") {
+  GIVEN("A large vector of structs") {
+    std::vector<JTC1> data(20000);
+    for(std::size_t i = 0; i < data.size(); ++i) {
+      data[i].path = std::to_string(i);
+      data[i].active = i % 3 == 0;
+    }
+    WHEN("The vector is serialized and deserialized again") {
+      sergut::JsonSerializer ser;
+      ser.serializeData(data);
+      sergut::JsonDeserializer deser(ser.str());
+      const std::vector<JTC1> desered = deser.deserializeData<std::vector<JTC1>>();
+
+      THEN("All elements are deserialized in order") {
+        CHECK(desered == data);
+      }
+    }
+  }
+}
+
+struct JTC4 {
+  int m01 = 0, m02 = 0, m03 = 0, m04 = 0, m05 = 0, m06 = 0, m07 = 0, m08 = 0, m09 = 0;
+  int m10 = 0, m11 = 0, m12 = 0, m13 = 0, m14 = 0, m15 = 0, m16 = 0, m17 = 0, m18 = 0;
+  JTC1 child;
+};
+
+SERGUT_FUNCTION(JTC4, data, ar) {
+  ar & SERGUT_MMEMBER(data, m01) & SERGUT_MMEMBER(data, m02) & SERGUT_MMEMBER(data, m03)
+      & SERGUT_MMEMBER(data, m04) & SERGUT_MMEMBER(data, m05) & SERGUT_MMEMBER(data, m06)
+      & SERGUT_MMEMBER(data, m07) & SERGUT_MMEMBER(data, m08) & SERGUT_MMEMBER(data, m09)
+      & SERGUT_MMEMBER(data, m10) & SERGUT_MMEMBER(data, m11) & SERGUT_MMEMBER(data, m12)
+      & SERGUT_MMEMBER(data, m13) & SERGUT_MMEMBER(data, m14) & SERGUT_MMEMBER(data, m15)
+      & SERGUT_MMEMBER(data, m16) & SERGUT_OMEMBER(data, m17) & SERGUT_OMEMBER(data, m18)
+      & SERGUT_MMEMBER(data, child);
+}
+
+TEST_CASE("Deserialize wide JSON objects", "[sergut]") {
+  GIVEN("An object with more members than are looked up linearly") {
+    const std::string members = "\"m18\":18,\"m02\":2,\"m03\":3,\"m04\":4,\"m05\":5,\"m06\":6,\"m07\":7,\"m08\":8,\"m09\":9,"
+                                "\"m10\":10,\"m11\":11,\"m12\":12,\"m13\":13,\"m14\":14,\"m15\":15,\"m16\":16,\"m17\":null,"
+                                "\"unknown\":[1,2],\"child\":{\"path\":\"p\",\"active\":false},\"m02\":22";
+    WHEN("All mandatory members are present") {
+      sergut::JsonDeserializer deser("{\"m01\":1," + members + "}");
+      const JTC4 desered = deser.deserializeData<JTC4>();
+
+      THEN("The members are found and the first of duplicate members is used") {
+        CHECK(desered.m01 == 1);
+        CHECK(desered.m02 == 2);
+        CHECK(desered.m09 == 9);
+        CHECK(desered.m16 == 16);
+        CHECK(desered.m17 == 0);
+        CHECK(desered.m18 == 18);
+        CHECK(desered.child.path == "p");
+        CHECK(desered.child.active == false);
+      }
+    }
+    WHEN("A mandatory member is missing") {
+      sergut::JsonDeserializer deser("{" + members + "}");
+
+      THEN("An exception is thrown") {
+        CHECK_THROWS_AS(deser.deserializeData<JTC4>(), sergut::ParsingException);
+      }
+    }
+  }
+}
+
+TEST_CASE("Deserialize JSON with a reused parse context", "[sergut]") {
+  GIVEN("Vectors of structs of different sizes") {
+    std::vector<std::vector<JTC1>> documents;
+    for(const std::size_t size: { 10, 2000, 1, 500 }) {
+      std::vector<JTC1> data(size);
+      for(std::size_t i = 0; i < data.size(); ++i) {
+        data[i].path = std::to_string(i * size);
+        data[i].active = i % 2 == 0;
+      }
+      documents.push_back(data);
+    }
+    WHEN("The vectors are deserialized one after the other with the same context") {
+      sergut::JsonDeserializer::ParseContext parseContext(256);
+      std::vector<std::vector<JTC1>> desered;
+      for(const std::vector<JTC1>& data: documents) {
+        sergut::JsonSerializer ser;
+        ser.serializeData(data);
+        sergut::JsonDeserializer deser(ser.str(), parseContext);
+        desered.push_back(deser.deserializeData<std::vector<JTC1>>());
+      }
+
+      THEN("All vectors are deserialized correctly") {
+        CHECK(desered == documents);
+      }
+    }
+    WHEN("The vectors are deserialized in place with the context of the thread") {
+      std::vector<std::vector<JTC1>> desered;
+      for(const std::vector<JTC1>& data: documents) {
+        sergut::JsonSerializer ser;
+        ser.serializeData(data);
+        const std::string json = ser.str();
+        sergut::JsonDeserializer deser(std::vector<char>(json.begin(), json.end()),
+                                       sergut::JsonDeserializer::ParseContext::forCurrentThread());
+        desered.push_back(deser.deserializeData<std::vector<JTC1>>());
+      }
+
+      THEN("All vectors are deserialized correctly") {
+        CHECK(desered == documents);
+      }
+    }
+    WHEN("Two deserializers are created with the same context at the same time") {
+      sergut::JsonDeserializer::ParseContext parseContext;
+      sergut::JsonSerializer ser1;
+      ser1.serializeData(documents[0]);
+      sergut::JsonSerializer ser2;
+      ser2.serializeData(documents[1]);
+      sergut::JsonDeserializer deser1(ser1.str(), parseContext);
+      sergut::JsonDeserializer deser2(ser2.str(), parseContext);
+      const std::vector<JTC1> desered2 = deser2.deserializeData<std::vector<JTC1>>();
+      const std::vector<JTC1> desered1 = deser1.deserializeData<std::vector<JTC1>>();
+
+      THEN("Both are deserialized correctly") {
+        CHECK(desered1 == documents[0]);
+        CHECK(desered2 == documents[1]);
+      }
+    }
+  }
+}
+
+struct JTC5 {
+  std::string key;
+  int value;
+};
+
+SERGUT_FUNCTION(JTC5, data, ar) {
+  // the name is taken from a buffer that is reused for every object
+  static char name[16];
+  std::strncpy(name, data.key.c_str(), sizeof(name) - 1);
+  ar & SERGUT_RENAMED_MMEMBER(data.value, name);
+}
+
+TEST_CASE("Serialize members with names from a reused buffer to JSON", "[sergut]") {
+  GIVEN("A vector of structs whose member names are set at runtime") {
+    const std::vector<JTC5> data{ { "a", 1 }, { "bb", 2 }, { "bb", 3 }, { "c", 4 } };
+    WHEN("The vector is serialized") {
+      sergut::JsonSerializer ser;
+      ser.serializeData(data);
+
+      THEN("Each object gets the key of its own name") {
+        CHECK(ser.str() == "[{\"a\":1},{\"bb\":2},{\"bb\":3},{\"c\":4}]");
+      }
+    }
+  }
+}
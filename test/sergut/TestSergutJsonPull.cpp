@@ -0,0 +1,311 @@
+#include <catch2/catch.hpp>
+
+#include "TestSupportClasses.h"
+
+#include "sergut/JsonDeserializer.h"
+#include "sergut/JsonPullDeserializer.h"
+#include "sergut/JsonSerializer.h"
+#include "sergut/ParsingException.h"
+
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST_CASE("Deserialize complex class from JSON without DOM", "[sergut]")
+{
+  GIVEN("A complex C++ POD datastructure")  {
+    const TestParent tp{ 21, 99, 124, TestChild{ -27, -42, Time{4, 45}, -23, 3.14159, 2.718f, -127 }, 65000, 255,
+                         "\nstring\\escaped\"quoted\" &<b>Daten</b>foo", "char* Daten", 'c', { {22}, {33}, {44} }, { 1, 2, 3, 4}, { -99 } };
+    WHEN("The serialized datastructure is deserialized") {
+      sergut::JsonSerializer ser;
+      ser.serializeData(tp);
+      sergut::JsonPullDeserializer deser(ser.str());
+      const TestParent tst = deser.deserializeData<TestParent>();
+
+      THEN("The result equals the original datastructure") {
+        CHECK(tp == tst);
+      }
+    }
+    WHEN("The members are in a different order and there are unknown members") {
+      const std::string req = "{\"childMember12\":{\"grandChildValue\":-99},\"unknown1\":{\"a\":[1,{\"b\":[]}],\"c\":\"d\"},"
+                              "\"intVectorMember11\":[1,2,3,4],\"intMember1\":21,\"intMember2\":99,\"intMember3\":124,"
+                              "\"childMember4\":{\"intMember7\":-127,\"intMember1\":-27,\"intMember2\":-42,"
+                              "\"timeMember3\":\"4:45:00\",\"intMember4\":-23,\"doubleMember5\":3.14159,"
+                              "\"floatMember6\":2.718},\"unknown2\":[[null,true]],\"intMember5\":{\"nestedIntMember5\":65000},"
+                              "\"intMember6\":255,\"stringMember7\":\"\\nstring\\\\escaped\\\"quoted\\\" &<b>Daten<\\/b>foo\","
+                              "\"charPtrMember8\":\"char* Daten\",\"charMember9\":\"c\","
+                              "\"childVectorMember10\":[{\"grandChildValue\":22},{\"grandChildValue\":33},{\"grandChildValue\":44}]}";
+      sergut::JsonPullDeserializer deser(req);
+      const TestParent tst = deser.deserializeData<TestParent>();
+      sergut::JsonPullDeserializer indexedDeser(sergut::json::PullParser::createIndexedParser(sergut::misc::ConstStringRef(req)));
+      const TestParent indexedTst = indexedDeser.deserializeData<TestParent>();
+
+      THEN("The result equals the original datastructure, also when using a structural index") {
+        CHECK(tp == tst);
+        CHECK(tp == indexedTst);
+      }
+    }
+  }
+}
+
+namespace {
+struct JPTC1 {
+  std::string path;
+  bool active = true;
+  int bar = 30;
+  std::list<double> values;
+  std::set<unsigned char> flags;
+};
+
+bool operator==(const JPTC1& lhs, const JPTC1& rhs) {
+  return lhs.path==rhs.path && lhs.active==rhs.active && lhs.bar==rhs.bar
+      && lhs.values==rhs.values && lhs.flags==rhs.flags;
+}
+
+SERGUT_FUNCTION(JPTC1, data, ar) {
+  ar & SERGUT_OMEMBER(data, path)
+      & SERGUT_OMEMBER(data, active)
+      & SERGUT_MMEMBER(data, bar)
+      & SERGUT_OMEMBER(data, values)
+      & SERGUT_OMEMBER(data, flags);
+}
+}
+
+TEST_CASE("Deserialize JSON without DOM", "[sergut]") {
+  GIVEN("A JPTC1")  {
+    JPTC1 tp;
+    tp.path = "/home/";
+    tp.bar = 12;
+    WHEN("The datastructure is deserialized with bool as int, real bool and bool as non-zero int") {
+      for(const std::string active: { "1", "true", "23" }) {
+        sergut::JsonPullDeserializer deser("{\"path\":\"\\/home\\/\",\"active\":" + active + ",\"bar\":12}");
+        const JPTC1 desered = deser.deserializeData<JPTC1>();
+
+        THEN("The result is the specified data for active=" + active) {
+          CHECK(desered == tp);
+        }
+      }
+    }
+    WHEN("Optional members are missing or null") {
+      sergut::JsonPullDeserializer deser("{\"path\":null,\"bar\":12}");
+      const JPTC1 desered = deser.deserializeData<JPTC1>();
+
+      THEN("They keep their default values") {
+        JPTC1 expected;
+        expected.bar = 12;
+        CHECK(desered == expected);
+      }
+    }
+    WHEN("Member names contain an escaped NUL character") {
+      sergut::JsonPullDeserializer deser("{\"bar\":12,\"path\\u0000\":\"a\",\"pa\\u0000\":\"b\",\"\\u0000\":1,\"bar\\u0000x\":1}");
+      const JPTC1 desered = deser.deserializeData<JPTC1>();
+
+      THEN("They do not match any member") {
+        JPTC1 expected;
+        expected.bar = 12;
+        CHECK(desered == expected);
+      }
+    }
+    WHEN("Members occur more than once") {
+      const std::string json = "{\"bar\":1,\"path\":\"a\",\"bar\":2,\"path\":\"b\",\"values\":null,\"values\":[1.5],"
+                               "\"flags\":[1],\"flags\":[2],\"active\":false,\"active\":null}";
+      sergut::JsonPullDeserializer deser(json);
+      const JPTC1 desered = deser.deserializeData<JPTC1>();
+      sergut::JsonDeserializer domDeser(json);
+      const JPTC1 domDesered = domDeser.deserializeData<JPTC1>();
+
+      THEN("The first occurrence is used, as with the JsonDeserializer") {
+        JPTC1 expected;
+        expected.path = "a";
+        expected.bar = 1;
+        expected.flags = { 1 };
+        expected.active = false;
+        CHECK(desered == expected);
+        CHECK(domDesered == expected);
+      }
+    }
+    WHEN("The collections are filled") {
+      sergut::JsonPullDeserializer deser(" { \"bar\" : 12 , \"values\" : [ 1 , -0.5 , 2.5e-3, 1E2, 123456789.123456789 ] , \"flags\" : [ 3 , 1 , 3 ] } ");
+      const JPTC1 desered = deser.deserializeData<JPTC1>();
+
+      THEN("The result contains the elements") {
+        JPTC1 expected;
+        expected.bar = 12;
+        expected.values = { 1, -0.5, 2.5e-3, 100, 123456789.123456789 };
+        expected.flags = { 1, 3 };
+        CHECK(desered == expected);
+      }
+    }
+    WHEN("A mandatory member is missing or null") {
+      for(const std::string json: { "{\"path\":\"/home/\"}", "{\"bar\":null}" }) {
+        sergut::JsonPullDeserializer deser(json);
+
+        THEN("An exception is thrown for " + json) {
+          CHECK_THROWS_AS(deser.deserializeData<JPTC1>(), sergut::ParsingException);
+        }
+      }
+    }
+    WHEN("The JSON is invalid or does not match the datatype") {
+      for(const std::string json: { "{\"bar\":12", "{\"bar\":12}}", "{\"bar\":12.5}", "{\"bar\":\"12\"}",
+                                    "{\"bar\":3000000000}", "{\"bar\":1,\"flags\":[256]}", "{\"bar\":1,\"flags\":[-1]}",
+                                    "{\"bar\":1,\"values\":{}}", "[]" }) {
+        sergut::JsonPullDeserializer deser(json);
+
+        THEN("An exception is thrown for " + json) {
+          CHECK_THROWS_AS(deser.deserializeData<JPTC1>(), sergut::ParsingException);
+        }
+      }
+    }
+    WHEN("The deserializer is used twice") {
+      sergut::JsonPullDeserializer deser("{\"bar\":12}");
+      deser.deserializeData<JPTC1>();
+
+      THEN("An exception is thrown") {
+        CHECK_THROWS_AS(deser.deserializeData<JPTC1>(), sergut::ParsingException);
+      }
+    }
+  }
+  GIVEN("Integral limits") {
+    WHEN("The extreme values are deserialized") {
+      THEN("They are read exactly") {
+        CHECK(sergut::JsonPullDeserializer("-9223372036854775808").deserializeData<long long>() == std::numeric_limits<long long>::min());
+        CHECK(sergut::JsonPullDeserializer("9223372036854775807").deserializeData<long long>() == std::numeric_limits<long long>::max());
+        CHECK(sergut::JsonPullDeserializer("18446744073709551615").deserializeData<unsigned long long>() == std::numeric_limits<unsigned long long>::max());
+        CHECK_THROWS_AS(sergut::JsonPullDeserializer("9223372036854775808").deserializeData<long long>(), sergut::ParsingException);
+        CHECK_THROWS_AS(sergut::JsonPullDeserializer("18446744073709551616").deserializeData<unsigned long long>(), sergut::ParsingException);
+      }
+    }
+  }
+}
+
+TEST_CASE("Deserialize JSON snippets", "[sergut]")
+{
+  GIVEN("A JSON array of JPTC1 that is received in small chunks")  {
+    const std::string json = "[{\"path\":\"\\/a\",\"bar\":1,\"values\":[1.5,-2]},"
+                             " {\"bar\":2,\"active\":false, \"unknown\": {\"x\": [1, 2]}},"
+                             " {\"path\":\"\\u00e4\\u00f6\",\"bar\":3,\"flags\":[7,9]}]";
+    std::vector<JPTC1> expected(3);
+    expected[0].path = "/a";
+    expected[0].bar = 1;
+    expected[0].values = { 1.5, -2 };
+    expected[1].bar = 2;
+    expected[1].active = false;
+    expected[2].path = "\xc3\xa4\xc3\xb6";
+    expected[2].bar = 3;
+    expected[2].flags = { 7, 9 };
+    for(const std::size_t chunkSize: { 1, 5, 16, 1000 }) {
+      WHEN("Deserializing the elements as they arrive with a chunk size of " + std::to_string(chunkSize)) {
+        std::unique_ptr<sergut::json::PullParser> parser =
+            sergut::json::PullParser::createParser(sergut::misc::ConstStringRef(std::string()));
+        std::size_t pos = 0;
+        const auto appendChunk = [&]() {
+          REQUIRE(pos < json.size());
+          const std::size_t size = std::min(chunkSize, json.size() - pos);
+          parser->appendData(json.data() + pos, size);
+          pos += size;
+        };
+        const auto parseNext = [&]() {
+          while(parser->parseNext() == sergut::json::ParseTokenType::IncompleteDocument) {
+            appendChunk();
+          }
+        };
+        std::vector<JPTC1> result;
+        std::size_t retries = 0;
+        parseNext();
+        REQUIRE(parser->getCurrentTokenType() == sergut::json::ParseTokenType::OpenArray);
+        parseNext();
+        while(parser->getCurrentTokenType() != sergut::json::ParseTokenType::CloseArray) {
+          REQUIRE(parser->setSavePointAtCurrentToken());
+          try {
+            result.push_back(sergut::JsonPullDeserializer::deserializeFromSnippet<JPTC1>(*parser));
+          } catch(const sergut::ParsingException&) {
+            REQUIRE(parser->getCurrentTokenType() == sergut::json::ParseTokenType::IncompleteDocument);
+            ++retries;
+            appendChunk();
+            REQUIRE(parser->restoreToSavePoint());
+            continue;
+          }
+          if(parser->getCurrentTokenType() == sergut::json::ParseTokenType::IncompleteDocument) {
+            appendChunk();
+            parseNext();
+          }
+        }
+        THEN("All elements are deserialized") {
+          CHECK(result == expected);
+          CHECK((retries == 0) == (chunkSize >= json.size()));
+          parseNext();
+          CHECK(parser->getCurrentTokenType() == sergut::json::ParseTokenType::CloseDocument);
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Deserialize the elements of a JSON array one by one", "[sergut]")
+{
+  GIVEN("A JSON array of JPTC1")  {
+    std::vector<JPTC1> expected(50);
+    for(std::size_t i = 0; i < expected.size(); ++i) {
+      expected[i].path = "/element/" + std::to_string(i);
+      expected[i].bar = static_cast<int>(i);
+      expected[i].values = std::list<double>(i % 5, 0.25 * i);
+      expected[i].active = (i % 3 != 0);
+    }
+    sergut::JsonSerializer ser;
+    ser.serializeData(expected);
+    const std::string json = ser.str() + "\n";
+    WHEN("Deserializing the elements out of the parser") {
+      sergut::JsonPullDeserializer deser(json);
+      std::vector<JPTC1> result;
+      const std::size_t count = deser.forEachArrayElement<JPTC1>([&](JPTC1&& data) { result.push_back(std::move(data)); });
+      THEN("All elements are passed to the callback") {
+        CHECK(count == expected.size());
+        CHECK(result == expected);
+      }
+    }
+    for(const std::size_t chunkSize: { 1, 7, 64 * 1024 }) {
+      WHEN("Deserializing the elements out of a stream with a chunk size of " + std::to_string(chunkSize)) {
+        std::istringstream input(json);
+        std::vector<JPTC1> result;
+        const std::size_t count = sergut::JsonPullDeserializer::forEachArrayElement<JPTC1>(
+              input, [&](JPTC1&& data) { result.push_back(std::move(data)); }, chunkSize);
+        THEN("All elements are passed to the callback") {
+          CHECK(count == expected.size());
+          CHECK(result == expected);
+        }
+      }
+    }
+    WHEN("The stream is cut off") {
+      std::istringstream input(json.substr(0, json.size() / 2));
+      std::size_t callbackCount = 0;
+      THEN("Deserializing throws after the complete elements") {
+        CHECK_THROWS_AS(sergut::JsonPullDeserializer::forEachArrayElement<JPTC1>(
+                          input, [&](JPTC1&&) { ++callbackCount; }, 16),
+                        sergut::ParsingException);
+        CHECK(callbackCount > 0);
+        CHECK(callbackCount < expected.size());
+      }
+    }
+    WHEN("There is data after the array") {
+      std::istringstream input(json + "  []");
+      THEN("Deserializing throws") {
+        CHECK_THROWS_AS(sergut::JsonPullDeserializer::forEachArrayElement<JPTC1>(input, [](JPTC1&&) { }, 16),
+                        sergut::ParsingException);
+      }
+    }
+  }
+  GIVEN("A JSON document that is not an array")  {
+    const std::string json = "{\"bar\":1}";
+    THEN("Deserializing the elements throws") {
+      sergut::JsonPullDeserializer deser(json);
+      CHECK_THROWS_AS(deser.forEachArrayElement<JPTC1>([](JPTC1&&) { }), sergut::ParsingException);
+      std::istringstream input(json);
+      CHECK_THROWS_AS(sergut::JsonPullDeserializer::forEachArrayElement<JPTC1>(input, [](JPTC1&&) { }),
+                      sergut::ParsingException);
+    }
+  }
+}
@@ -0,0 +1,220 @@
+#include <catch2/catch.hpp>
+
+#include "sergut/JsonSerializer.h"
+#include "sergut/NdJsonDeserializer.h"
+#include "sergut/ParsingException.h"
+#include "sergut/misc/ThreadPool.h"
+
+#include <algorithm>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+struct NdTC1 {
+  std::string name;
+  int value = 0;
+  std::vector<int> list;
+};
+
+bool operator==(const NdTC1& lhs, const NdTC1& rhs) {
+  return lhs.name == rhs.name && lhs.value == rhs.value && lhs.list == rhs.list;
+}
+
+SERGUT_FUNCTION(NdTC1, data, ar) {
+  ar & SERGUT_MMEMBER(data, name)
+      & SERGUT_OMEMBER(data, value)
+      & SERGUT_OMEMBER(data, list);
+}
+
+std::vector<NdTC1> createRecords(const std::size_t count) {
+  std::vector<NdTC1> records(count);
+  for(std::size_t i = 0; i < count; ++i) {
+    records[i].name = "record " + std::to_string(i);
+    records[i].value = static_cast<int>(i) * 7 - 100;
+    records[i].list.assign(i % 4, static_cast<int>(i));
+  }
+  return records;
+}
+}
+
+TEST_CASE("Deserialize newline delimited JSON", "[sergut]")
+{
+  GIVEN("NDJSON with empty lines, CRLF line endings and without a newline at the end") {
+    const std::vector<NdTC1> records = createRecords(50);
+    std::string ndjson;
+    for(std::size_t i = 0; i < records.size(); ++i) {
+      sergut::JsonSerializer ser;
+      ser.serializeData(records[i]);
+      ndjson += ser.str();
+      if(i + 1 < records.size()) {
+        ndjson += i % 5 == 0 ? "\r\n" : "\n";
+      }
+      if(i % 7 == 1) {
+        ndjson += " \n\n";
+      }
+    }
+    for(const std::size_t chunkSize: { 1, 3, 64, 100000 }) {
+      WHEN("The data is appended in chunks of " + std::to_string(chunkSize) + " bytes") {
+        sergut::NdJsonDeserializer deser;
+        std::vector<NdTC1> desered;
+        for(std::size_t pos = 0; pos < ndjson.size(); pos += chunkSize) {
+          deser.appendData(ndjson.data() + pos, std::min(chunkSize, ndjson.size() - pos));
+          deser.deserializeRecords<NdTC1>(desered);
+        }
+        const std::size_t recordsBeforeFinish = desered.size();
+        deser.finish();
+        deser.deserializeRecords<NdTC1>(desered);
+
+        THEN("The last record is only deserialized after finish() and all records are deserialized in order") {
+          CHECK(recordsBeforeFinish == records.size() - 1);
+          CHECK(desered == records);
+        }
+      }
+    }
+    WHEN("The data is read from a stream") {
+      std::istringstream input(ndjson);
+      std::vector<NdTC1> desered;
+      const std::size_t recordCount =
+          sergut::NdJsonDeserializer::deserializeStream<NdTC1>(input, [&desered](NdTC1&& record) {
+        desered.push_back(std::move(record));
+      });
+
+      THEN("All records are passed to the callback in order") {
+        CHECK(recordCount == records.size());
+        CHECK(desered == records);
+      }
+    }
+  }
+  GIVEN("NDJSON with invalid records") {
+    const std::string ndjson = "{\"name\":\"a\"}\n{\"name\":\"b\"\n{\"value\":1}\n{\"name\":\"c\"} 1\n{\"name\":\"d\"}\n";
+    WHEN("The records are deserialized") {
+      sergut::NdJsonDeserializer deser;
+      deser.appendData(sergut::misc::ConstStringRef(ndjson));
+      std::vector<NdTC1> desered;
+      std::vector<std::size_t> errorLines;
+      for(bool done = false; !done; ) {
+        try {
+          deser.deserializeRecords<NdTC1>(desered);
+          done = true;
+        } catch(const sergut::ParsingException&) {
+          errorLines.push_back(deser.getLineNumber());
+        }
+      }
+
+      THEN("The invalid records are reported with their line numbers and skipped") {
+        REQUIRE(desered.size() == 2);
+        CHECK(desered[0].name == "a");
+        CHECK(desered[1].name == "d");
+        CHECK(errorLines == std::vector<std::size_t>({ 2, 3, 4 }));
+      }
+    }
+  }
+  GIVEN("NDJSON with a record with a member of the wrong type") {
+    const std::string ndjson = "{\"name\":\"a\"}\n\n{\"name\":\"b\",\"value\":\"x\"}\n{\"name\":\"c\"}\n";
+    WHEN("The records are deserialized") {
+      sergut::NdJsonDeserializer deser;
+      deser.appendData(sergut::misc::ConstStringRef(ndjson));
+      std::vector<NdTC1> desered;
+
+      THEN("The error message contains the line of the invalid record") {
+        CHECK_THROWS_WITH(deser.deserializeRecords<NdTC1>(desered), Catch::Contains("(3, 0)"));
+        CHECK(deser.getLineNumber() == 3);
+        CHECK(deser.deserializeRecords<NdTC1>(desered) == 1);
+        CHECK(desered.size() == 2);
+      }
+    }
+  }
+}
+
+TEST_CASE("Deserialize newline delimited JSON in parallel", "[sergut]")
+{
+  GIVEN("NDJSON with many records") {
+    const std::vector<NdTC1> records = createRecords(1000);
+    std::string ndjson;
+    for(const NdTC1& record: records) {
+      sergut::JsonSerializer ser;
+      ser.serializeData(record);
+      ndjson += ser.str() + "\n";
+    }
+    sergut::misc::ThreadPool pool(3);
+    WHEN("The records are deserialized in input order") {
+      sergut::NdJsonDeserializer deser;
+      deser.setThreadPool(&pool, sergut::NdJsonDeserializer::RecordOrder::InputOrder, 7);
+      std::vector<NdTC1> desered;
+      std::size_t recordCount = 0;
+      const std::size_t half = ndjson.size() / 2;
+      deser.appendData(ndjson.data(), half);
+      recordCount += deser.deserializeRecords<NdTC1>(desered);
+      deser.appendData(ndjson.data() + half, ndjson.size() - half);
+      recordCount += deser.deserializeRecords<NdTC1>(desered);
+
+      THEN("All records are deserialized in order") {
+        CHECK(recordCount == records.size());
+        CHECK(desered == records);
+        CHECK(deser.getLineNumber() == records.size());
+      }
+    }
+    WHEN("The records are deserialized unordered") {
+      sergut::NdJsonDeserializer deser;
+      deser.setThreadPool(&pool, sergut::NdJsonDeserializer::RecordOrder::Unordered, 16);
+      deser.appendData(sergut::misc::ConstStringRef(ndjson));
+      std::mutex mutex;
+      std::vector<NdTC1> desered;
+      const std::size_t recordCount = deser.deserializeRecords<NdTC1>([&](NdTC1&& record) {
+        std::lock_guard<std::mutex> lock(mutex);
+        desered.push_back(std::move(record));
+      });
+      std::sort(desered.begin(), desered.end(), [](const NdTC1& lhs, const NdTC1& rhs) { return lhs.value < rhs.value; });
+
+      THEN("All records are deserialized") {
+        CHECK(recordCount == records.size());
+        CHECK(desered == records);
+      }
+    }
+  }
+  GIVEN("NDJSON with invalid records") {
+    const std::string ndjson = "{\"name\":\"a\"}\n{\"name\":\"b\"\n{\"value\":1}\n{\"name\":\"c\"} 1\n{\"name\":\"d\"}\n";
+    WHEN("The records are deserialized in parallel") {
+      sergut::misc::ThreadPool pool(2);
+      sergut::NdJsonDeserializer deser;
+      deser.setThreadPool(&pool, sergut::NdJsonDeserializer::RecordOrder::InputOrder, 2);
+      deser.appendData(sergut::misc::ConstStringRef(ndjson));
+      std::vector<NdTC1> desered;
+      CHECK_THROWS_AS(deser.deserializeRecords<NdTC1>(desered), sergut::ParsingException);
+      const std::size_t errorLine = deser.getLineNumber();
+
+      THEN("The valid records are deserialized and the first invalid one is reported") {
+        REQUIRE(desered.size() == 2);
+        CHECK(desered[0].name == "a");
+        CHECK(desered[1].name == "d");
+        CHECK(errorLine == 2);
+        CHECK(deser.deserializeRecords<NdTC1>(desered) == 0);
+      }
+    }
+    WHEN("The records are appended and deserialized in parallel in several batches") {
+      sergut::misc::ThreadPool pool(2);
+      sergut::NdJsonDeserializer deser;
+      deser.setThreadPool(&pool, sergut::NdJsonDeserializer::RecordOrder::InputOrder, 2);
+      std::vector<NdTC1> desered;
+      std::vector<std::size_t> errorLines;
+      for(const std::string batch: { "{\"name\":\"a\"}\n{\"value\":1}\n{\"name\":\"b\"}\n",
+                                     "{\"name\":\"c\"}\n{\"name\":\"d\"}\n{\"name\":1}\n",
+                                     "{\"name\":\"e\"}\n" }) {
+        deser.appendData(sergut::misc::ConstStringRef(batch));
+        try {
+          deser.deserializeRecords<NdTC1>(desered);
+        } catch(const sergut::ParsingException&) {
+          errorLines.push_back(deser.getLineNumber());
+        }
+      }
+
+      THEN("The invalid record of each batch is reported with its line number") {
+        CHECK(desered.size() == 5);
+        CHECK(errorLines == std::vector<std::size_t>({ 2, 6 }));
+        CHECK(deser.getLineNumber() == 7);
+      }
+    }
+  }
+}
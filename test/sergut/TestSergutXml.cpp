@@ -27,6 +27,7 @@
 #include "sergut/XmlDeserializerTiny.h"
 #include "sergut/XmlDeserializerTiny2.h"
 #include "sergut/XmlSerializer.h"
+#include "sergut/XmlSnippetDeserializer.h"
 #include "sergut/SerializerBase.h"
 #include "sergut/DeserializerBase.h"
 
@@ -35,6 +36,9 @@
 #include <iostream>
 #include <vector>
 
+#include <stdlib.h>
+#include <unistd.h>
+
 ////////////////////////////////////////////////////////////////////////////////
 // check error handling
 ////////////////////////////////////////////////////////////////////////////////
@@ -1021,6 +1025,72 @@ TEST_CASE("Deserialize incomplete XML with resume", "[sergut]")
 }
 
 
+TEST_CASE("Deserialize incomplete XML with the XmlSnippetDeserializer", "[sergut]")
+{
+  constexpr int REPETITION_COUNT=3;
+  std::string xml = "<root>\n";
+  for(int i = 0; i < REPETITION_COUNT; ++i) {
+    xml += "  <inner att=\"" + std::to_string(i) + "\"><v>" + std::to_string(i + 1) + "</v></inner>\n";
+  }
+  xml += "</root>";
+  for(const std::size_t chunkSize: {std::size_t(1), std::size_t(2), std::size_t(7), xml.size()}) {
+    GIVEN("The XML is appended in chunks of " + std::to_string(chunkSize) + " characters") {
+      std::size_t pos = std::min(chunkSize, xml.size());
+      std::unique_ptr<sergut::xml::PullParser> parserTmp = sergut::xml::PullParser::createParser(sergut::misc::ConstStringRef(xml.data(), xml.data() + pos));
+      sergut::xml::PullParser& parser = *parserTmp;
+      const auto appendNextChunk = [&]() {
+        const std::size_t size = std::min(chunkSize, xml.size() - pos);
+        parser.appendData(xml.data() + pos, size);
+        pos += size;
+        return size != 0;
+      };
+      while(parser.getCurrentTokenType() != sergut::xml::ParseTokenType::OpenTag || parser.getCurrentTagName() != std::string("inner")) {
+        if(parser.parseNext() == sergut::xml::ParseTokenType::IncompleteDocument) {
+          REQUIRE(appendNextChunk());
+        }
+        REQUIRE(parser.getCurrentTokenType() != sergut::xml::ParseTokenType::Error);
+      }
+      WHEN("Deserializing the elements, appending data whenever more data is needed") {
+        sergut::XmlSnippetDeserializer deser(parser);
+        std::size_t needMoreDataCount = 0;
+        THEN("All elements are deserialized without restarting") {
+          for(int i = 0; i < REPETITION_COUNT; ++i) {
+            SavepointTest data;
+            while(deser.deserializeFromSnippet("inner", data) == sergut::XmlSnippetDeserializer::Status::NeedMoreData) {
+              REQUIRE(appendNextChunk());
+              ++needMoreDataCount;
+            }
+            CHECK(data == (SavepointTest{i, i + 1}));
+          }
+          CHECK(parser.getCurrentTokenType() == sergut::xml::ParseTokenType::CloseTag);
+          CHECK(parser.getCurrentTagName() == std::string("root"));
+          if(chunkSize == 1) {
+            CHECK(needMoreDataCount != 0);
+          }
+        }
+      }
+    }
+  }
+  GIVEN("An element that does not match the data type") {
+    const std::string xml = "<root><inner att=\"x\"><v>1</v></inner><inner att=\"2\"><v>3</v></inner></root>";
+    std::unique_ptr<sergut::xml::PullParser> parserTmp = sergut::xml::PullParser::createParser(sergut::misc::ConstStringRef(xml));
+    sergut::xml::PullParser& parser = *parserTmp;
+    CHECK(parser.parseNext() == sergut::xml::ParseTokenType::OpenDocument);
+    CHECK(parser.parseNext() == sergut::xml::ParseTokenType::OpenTag);
+    CHECK(parser.parseNext() == sergut::xml::ParseTokenType::OpenTag);
+    WHEN("Deserializing the elements") {
+      sergut::XmlSnippetDeserializer deser(parser);
+      THEN("The invalid element is dropped and the next one is deserialized") {
+        SavepointTest data;
+        CHECK_THROWS_AS(deser.deserializeFromSnippet("wrongName", data), sergut::ParsingException);
+        CHECK(deser.deserializeFromSnippet("inner", data) == sergut::XmlSnippetDeserializer::Status::Complete);
+        CHECK(data == (SavepointTest{2, 3}));
+      }
+    }
+  }
+}
+
+
 /*
  *  TODO:
  * * UTF-16 handling
@@ -1219,6 +1289,48 @@ TEST_CASE("Serialize complex class", "[sergut]")
         CHECK(ser.str() == req);
       }
     }
+    WHEN("The datastructure is serialized to XML into a caller provided string") {
+      std::string result;
+      {
+        sergut::misc::StringSink sink(result);
+        sergut::XmlSerializer ser(sink);
+        ser.serializeData("Dummy", tp);
+        ser.flush();
+      }
+      sergut::XmlSerializer ser;
+      ser.serializeData("Dummy", tp);
+
+      THEN("The result is the same as with the internal buffer") {
+        CHECK(result == ser.str());
+      }
+    }
+    WHEN("A serializer is reset and serializes the datastructure again") {
+      sergut::XmlSerializer ser;
+      ser.serializeData("Dummy", tp);
+      const std::string first = ser.str();
+      const std::size_t capacity = ser.data().capacity();
+      ser.reset();
+      CHECK(ser.data() == "");
+      ser.serializeData("Dummy", tp);
+
+      THEN("The result only contains the new data and the buffer is kept") {
+        CHECK(ser.data() == first);
+        CHECK(ser.data().capacity() == capacity);
+      }
+    }
+    WHEN("A vector of the datastructure is serialized to XML in parallel") {
+      const std::vector<TestParent> parents(100, tp);
+      sergut::misc::ThreadPool pool(3);
+      sergut::XmlSerializer ser;
+      ser.setThreadPool(&pool, 8);
+      ser.serializeNestedData("Parents", "Parent", sergut::XmlValueType::Child, parents);
+      sergut::XmlSerializer sequentialSer;
+      sequentialSer.serializeNestedData("Parents", "Parent", sergut::XmlValueType::Child, parents);
+
+      THEN("The result is the same as the sequential one") {
+        CHECK(ser.str() == sequentialSer.str());
+      }
+    }
     WHEN("The datastructure is serialized to XML, then deserialized from XML, and serialized again") {
       THEN("The two serializations are equal using XmlDeserializer") {
         sergut::XmlSerializer ser;
@@ -1230,6 +1342,28 @@ TEST_CASE("Serialize complex class", "[sergut]")
         ser2.serializeData("Dummy", tp);
         CHECK(ser.str() == ser2.str());
       }
+      THEN("The deserialized datastructure equals the original using XmlDeserializer on borrowed XML") {
+        sergut::XmlSerializer ser;
+        ser.serializeData("Dummy", tp);
+        const std::string xmlResult = ser.str();
+        sergut::XmlDeserializer deser(sergut::misc::ConstStringRef(xmlResult), sergut::xml::PullParser::DataOwnership::Borrow);
+        const TestParent tpDeser = deser.deserializeData<TestParent>("Dummy");
+        CHECK(tpDeser == tp);
+      }
+      THEN("The deserialized datastructure equals the original using XmlDeserializer on a file") {
+        sergut::XmlSerializer ser;
+        ser.serializeData("Dummy", tp);
+        const std::string xmlResult = ser.str();
+        char path[] = "/tmp/sergutTestSergutXmlXXXXXX";
+        const int fd = ::mkstemp(path);
+        REQUIRE(fd >= 0);
+        REQUIRE(::write(fd, xmlResult.data(), xmlResult.size()) == static_cast<ssize_t>(xmlResult.size()));
+        ::close(fd);
+        sergut::XmlDeserializer deser(sergut::xml::PullParser::createParserFromFile(path));
+        ::unlink(path);
+        const TestParent tpDeser = deser.deserializeData<TestParent>("Dummy");
+        CHECK(tpDeser == tp);
+      }
       THEN("The two serializations are equal using XmlDeserializerTiny") {
         sergut::XmlSerializer ser;
         ser.serializeData("Dummy", tp);
@@ -0,0 +1,254 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "sergut/json/PullParser.h"
+
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+using sergut::json::ParseTokenType;
+
+static std::unique_ptr<sergut::json::PullParser> createParser(const std::string& json)
+{
+  return sergut::json::PullParser::createParser(sergut::misc::ConstStringRef(json));
+}
+
+TEST_CASE("JSON-Parser (Simple Tests)", "[JSON]")
+{
+  GIVEN("The UTF-8 PullParser") {
+    WHEN("Parsing a scalar top level value") {
+      std::unique_ptr<sergut::json::PullParser> parser = createParser(" -12.5e3 ");
+      THEN("The number is reported with its literal text") {
+        CHECK(parser->parseNext() == ParseTokenType::Number);
+        CHECK(parser->getCurrentValue() == std::string("-12.5e3"));
+        CHECK(parser->parseNext() == ParseTokenType::CloseDocument);
+        CHECK(parser->parseNext() == ParseTokenType::CloseDocument);
+      }
+    }
+    WHEN("Parsing nested objects and arrays") {
+      std::unique_ptr<sergut::json::PullParser> parser =
+          createParser("{\"a\": [1, true, false, null, \"x\"], \"b\": {}, \"c\": [], \"d\": {\"e\": 0}}");
+      THEN("The result is the specified sequence") {
+        CHECK(parser->parseNext() == ParseTokenType::OpenObject);
+        CHECK(parser->getCurrentDepth() == 1);
+        CHECK(parser->parseNext() == ParseTokenType::MemberName);
+        CHECK(parser->getCurrentMemberName() == std::string("a"));
+        CHECK(parser->parseNext() == ParseTokenType::OpenArray);
+        CHECK(parser->getCurrentDepth() == 2);
+        CHECK(parser->parseNext() == ParseTokenType::Number);
+        CHECK(parser->getCurrentValue() == std::string("1"));
+        CHECK(parser->parseNext() == ParseTokenType::True);
+        CHECK(parser->parseNext() == ParseTokenType::False);
+        CHECK(parser->parseNext() == ParseTokenType::Null);
+        CHECK(parser->parseNext() == ParseTokenType::String);
+        CHECK(parser->getCurrentValue() == std::string("x"));
+        CHECK(parser->parseNext() == ParseTokenType::CloseArray);
+        CHECK(parser->getCurrentDepth() == 1);
+        CHECK(parser->parseNext() == ParseTokenType::MemberName);
+        CHECK(parser->getCurrentMemberName() == std::string("b"));
+        CHECK(parser->parseNext() == ParseTokenType::OpenObject);
+        CHECK(parser->parseNext() == ParseTokenType::CloseObject);
+        CHECK(parser->parseNext() == ParseTokenType::MemberName);
+        CHECK(parser->getCurrentMemberName() == std::string("c"));
+        CHECK(parser->parseNext() == ParseTokenType::OpenArray);
+        CHECK(parser->parseNext() == ParseTokenType::CloseArray);
+        CHECK(parser->parseNext() == ParseTokenType::MemberName);
+        CHECK(parser->getCurrentMemberName() == std::string("d"));
+        CHECK(parser->parseNext() == ParseTokenType::OpenObject);
+        CHECK(parser->parseNext() == ParseTokenType::MemberName);
+        CHECK(parser->getCurrentMemberName() == std::string("e"));
+        CHECK(parser->parseNext() == ParseTokenType::Number);
+        CHECK(parser->parseNext() == ParseTokenType::CloseObject);
+        CHECK(parser->parseNext() == ParseTokenType::CloseObject);
+        CHECK(parser->getCurrentDepth() == 0);
+        CHECK(parser->parseNext() == ParseTokenType::CloseDocument);
+      }
+    }
+    WHEN("Parsing strings with escape sequences") {
+      std::unique_ptr<sergut::json::PullParser> parser =
+          createParser("[\"a\\\"b\\\\c\\/d\\b\\f\\n\\r\\t\", \"\\u00e4\\u20AC\\ud83d\\ude00\", \"\xc3\xa4\"]");
+      THEN("The strings are decoded") {
+        CHECK(parser->parseNext() == ParseTokenType::OpenArray);
+        CHECK(parser->parseNext() == ParseTokenType::String);
+        CHECK(parser->getCurrentValue() == std::string("a\"b\\c/d\b\f\n\r\t"));
+        CHECK(parser->parseNext() == ParseTokenType::String);
+        CHECK(parser->getCurrentValue() == std::string("\xc3\xa4\xe2\x82\xac\xf0\x9f\x98\x80"));
+        CHECK(parser->parseNext() == ParseTokenType::String);
+        CHECK(parser->getCurrentValue() == std::string("\xc3\xa4"));
+        CHECK(parser->parseNext() == ParseTokenType::CloseArray);
+        CHECK(parser->parseNext() == ParseTokenType::CloseDocument);
+      }
+    }
+    WHEN("Parsing a document with a byte order mark") {
+      std::unique_ptr<sergut::json::PullParser> parser = createParser("\xef\xbb\xbf[]");
+      THEN("The byte order mark is skipped") {
+        CHECK(parser->parseNext() == ParseTokenType::OpenArray);
+        CHECK(parser->parseNext() == ParseTokenType::CloseArray);
+        CHECK(parser->parseNext() == ParseTokenType::CloseDocument);
+      }
+    }
+  }
+}
+
+TEST_CASE("JSON-Parser (Invalid documents)", "[JSON]")
+{
+  GIVEN("The UTF-8 PullParser") {
+    for(const std::string json: { "[1,]", "{\"a\" 1}", "{\"a\":1,}", "[1 2]", "[1}", "{1:2}", "01", "1.", "-",
+                                  "tru", "\"\\x\"", "\"a\nb\"", "\"\\ud83d\"", "[] []", "{\"a\":}" })
+    {
+      WHEN("Parsing '" + json + "'") {
+        std::unique_ptr<sergut::json::PullParser> parser = createParser(json);
+        THEN("An error or an incomplete document is reported") {
+          ParseTokenType tokenType = parser->parseNext();
+          while(parser->isOk() && tokenType != ParseTokenType::CloseDocument) {
+            tokenType = parser->parseNext();
+          }
+          CHECK_FALSE(parser->isOk());
+          // the parser stays in the error state
+          CHECK(parser->parseNext() == tokenType);
+        }
+      }
+    }
+    WHEN("Parsing a truncated document") {
+      std::unique_ptr<sergut::json::PullParser> parser = createParser("{\"a\": [1, \"b");
+      THEN("An incomplete document is reported") {
+        CHECK(parser->parseNext() == ParseTokenType::OpenObject);
+        CHECK(parser->parseNext() == ParseTokenType::MemberName);
+        CHECK(parser->parseNext() == ParseTokenType::OpenArray);
+        CHECK(parser->parseNext() == ParseTokenType::Number);
+        CHECK(parser->parseNext() == ParseTokenType::IncompleteDocument);
+      }
+    }
+  }
+}
+
+namespace {
+using Token = std::pair<ParseTokenType, std::string>;
+
+Token getToken(const sergut::json::PullParser& parser)
+{
+  switch(parser.getCurrentTokenType()) {
+  case ParseTokenType::MemberName:
+    return Token(parser.getCurrentTokenType(), parser.getCurrentMemberName().toString());
+  case ParseTokenType::String:
+  case ParseTokenType::Number:
+    return Token(parser.getCurrentTokenType(), parser.getCurrentValue().toString());
+  default:
+    return Token(parser.getCurrentTokenType(), std::string());
+  }
+}
+}
+
+TEST_CASE("JSON-Parser (incremental Tests)", "[JSON]")
+{
+  const std::string json{ "{\"a\": [1, -2.5e3, true, false, null, \"x\\u00e4y\"], \"b\" : {\"c\\n\": {}, \"d\": []},"
+                          "\"e\": [{\"f\": \"g\"}, {\"f\": \"h\"}, {\"f\": 12345}]}" };
+  std::vector<Token> expectedTokens;
+  {
+    std::unique_ptr<sergut::json::PullParser> parser = createParser(json);
+    while(parser->parseNext() != ParseTokenType::CloseDocument) {
+      REQUIRE(parser->isOk());
+      expectedTokens.push_back(getToken(*parser));
+    }
+  }
+  GIVEN("The UTF-8 PullParser") {
+    WHEN("Feeding the document char by char and calling parseNext() after each incomplete token") {
+      std::unique_ptr<sergut::json::PullParser> parser = createParser(std::string());
+      std::vector<Token> tokens;
+      for(std::size_t pos = 0; pos <= json.size(); ++pos) {
+        while(parser->parseNext() != ParseTokenType::IncompleteDocument && parser->isOk()
+              && parser->getCurrentTokenType() != ParseTokenType::CloseDocument)
+        {
+          tokens.push_back(getToken(*parser));
+        }
+        if(pos < json.size()) {
+          parser->appendData(json.data() + pos, 1);
+        }
+      }
+      THEN("The same tokens are reported as for the complete document") {
+        CHECK(tokens == expectedTokens);
+        CHECK(parser->getCurrentTokenType() == ParseTokenType::CloseDocument);
+      }
+    }
+    WHEN("Feeding the document char by char and returning to a save point after each incomplete token") {
+      // the indexes of the tokens at which save points are set
+      const std::set<std::size_t> savePoints{ 0, 2, 9, 11, 19, 24, 28 };
+      std::unique_ptr<sergut::json::PullParser> parser = createParser(json.substr(0, 1));
+      std::size_t currentTokenIdx = 0;
+      std::size_t currentSaveTokenIdx = 0;
+      REQUIRE(parser->parseNext() == ParseTokenType::OpenObject);
+      REQUIRE(parser->setSavePointAtCurrentToken());
+      for(std::size_t currentPos = 1; currentPos <= json.size(); ++currentPos) {
+        for(; currentTokenIdx < expectedTokens.size(); ++currentTokenIdx) {
+          CHECK(getToken(*parser) == expectedTokens[currentTokenIdx]);
+          if(savePoints.find(currentTokenIdx) != savePoints.end()) {
+            CHECK(parser->setSavePointAtCurrentToken());
+            currentSaveTokenIdx = currentTokenIdx;
+          }
+          if(!isOk(parser->parseNext())) {
+            break;
+          }
+        }
+        if(currentTokenIdx == expectedTokens.size()) {
+          break;
+        }
+        CHECK(parser->getCurrentTokenType() == ParseTokenType::IncompleteDocument);
+        if(currentPos % 2 == 0) {
+          parser->appendData(json.data() + currentPos, 1);
+          CHECK(parser->restoreToSavePoint());
+        } else {
+          CHECK(parser->restoreToSavePoint());
+          parser->appendData(json.data() + currentPos, 1);
+        }
+        currentTokenIdx = currentSaveTokenIdx;
+      }
+      THEN("All tokens have been reported in the right order") {
+        CHECK(currentTokenIdx == expectedTokens.size());
+        CHECK(parser->getCurrentTokenType() == ParseTokenType::CloseDocument);
+        CHECK(parser->getCurrentDepth() == 0);
+      }
+    }
+    WHEN("Restoring to a save point after parsing the rest of the document") {
+      std::unique_ptr<sergut::json::PullParser> parser = createParser("[{\"a\": 1}, \"b\"]");
+      CHECK(parser->parseNext() == ParseTokenType::OpenArray);
+      CHECK(parser->parseNext() == ParseTokenType::OpenObject);
+      CHECK(parser->setSavePointAtCurrentToken());
+      while(parser->parseNext() != ParseTokenType::CloseDocument) { }
+      THEN("The parser continues at the save point") {
+        CHECK(parser->restoreToSavePoint());
+        CHECK(parser->getCurrentTokenType() == ParseTokenType::OpenObject);
+        CHECK(parser->getCurrentDepth() == 2);
+        CHECK(parser->parseNext() == ParseTokenType::MemberName);
+        CHECK(parser->getCurrentMemberName() == std::string("a"));
+        CHECK(parser->parseNext() == ParseTokenType::Number);
+        CHECK(parser->parseNext() == ParseTokenType::CloseObject);
+        CHECK(parser->parseNext() == ParseTokenType::String);
+        CHECK(parser->parseNext() == ParseTokenType::CloseArray);
+        CHECK(parser->parseNext() == ParseTokenType::CloseDocument);
+      }
+    }
+  }
+}
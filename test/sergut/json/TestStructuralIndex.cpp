@@ -0,0 +1,182 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "sergut/json/PullParser.h"
+#include "sergut/json/detail/StructuralIndex.h"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using sergut::json::ParseTokenType;
+using sergut::json::detail::StructuralIndex;
+
+namespace {
+const StructuralIndex::Implementation implementations[] = {
+  StructuralIndex::Implementation::Scalar,
+  StructuralIndex::Implementation::Sse2,
+  StructuralIndex::Implementation::Avx2
+};
+
+std::string toString(const StructuralIndex::Implementation implementation)
+{
+  switch(implementation) {
+  case StructuralIndex::Implementation::Scalar: return "scalar";
+  case StructuralIndex::Implementation::Sse2:   return "SSE2";
+  case StructuralIndex::Implementation::Avx2:   return "AVX2";
+  }
+  return "unknown";
+}
+
+std::vector<uint32_t> buildIndex(const std::string& json, const StructuralIndex::Implementation implementation)
+{
+  StructuralIndex index;
+  REQUIRE(index.build(json.data(), json.size(), implementation));
+  return index.getPositions();
+}
+
+std::vector<std::pair<ParseTokenType, std::string>> parseAll(sergut::json::PullParser& parser)
+{
+  std::vector<std::pair<ParseTokenType, std::string>> tokens;
+  do {
+    parser.parseNext();
+    tokens.emplace_back(parser.getCurrentTokenType(),
+                        parser.getCurrentTokenType() == ParseTokenType::MemberName
+                        ? parser.getCurrentMemberName().toString() : parser.getCurrentValue().toString());
+  } while(parser.isOk() && parser.getCurrentTokenType() != ParseTokenType::CloseDocument);
+  return tokens;
+}
+}
+
+TEST_CASE("JSON structural index", "[JSON]")
+{
+  for(const StructuralIndex::Implementation implementation: implementations) {
+    if(!StructuralIndex::isSupported(implementation)) {
+      continue;
+    }
+    GIVEN("The " + toString(implementation) + " implementation") {
+      WHEN("Indexing a small document") {
+        // 0         1           2           3
+        // 0123456789012345 67 8 901234567 8 901234567
+        // {"a": [1, "x\"]" , \t true], "b\\": {}}
+        const std::string json = "{\"a\": [1, \"x\\\"]\" , \t true], \"b\\\\\": {}}";
+        THEN("The operators, the opening quotes and the starts of the values are indexed") {
+          CHECK(buildIndex(json, implementation)
+                == std::vector<uint32_t>({ 0, 1, 4, 6, 7, 8, 10, 17, 21, 25, 26, 28, 33, 35, 36, 37, 38 }));
+        }
+      }
+      WHEN("Indexing random documents with strings and escape sequences across the block boundaries") {
+        std::mt19937 rng(42);
+        const char alphabet[] = "{}[]:, \t\n\r\"\\abc01-";
+        for(int round = 0; round < 200; ++round) {
+          std::string json(rng() % 300, ' ');
+          for(char& c: json) {
+            c = alphabet[rng() % (sizeof(alphabet) - 1)];
+          }
+          THEN("The result equals the one of the scalar implementation (round " + std::to_string(round) + ")") {
+            CHECK(buildIndex(json, implementation) == buildIndex(json, StructuralIndex::Implementation::Scalar));
+          }
+        }
+      }
+    }
+  }
+  GIVEN("A document with long strings and backslash sequences of different lengths") {
+    std::string json = "[";
+    for(int i = 0; i < 100; ++i) {
+      json += "\"" + std::string(static_cast<std::size_t>(i), 'x') + std::string(static_cast<std::size_t>(i % 5), '\\')
+          + (i % 5 % 2 == 1 ? "\"" : "") + "\" ,\n";
+    }
+    json += "{\"end\": [true, null]}]";
+    WHEN("Parsing it with and without structural index") {
+      std::unique_ptr<sergut::json::PullParser> plainParser = sergut::json::PullParser::createParser(sergut::misc::ConstStringRef(json));
+      std::unique_ptr<sergut::json::PullParser> indexedParser = sergut::json::PullParser::createIndexedParser(sergut::misc::ConstStringRef(json));
+      THEN("The same tokens are reported") {
+        CHECK(parseAll(*indexedParser) == parseAll(*plainParser));
+        CHECK(indexedParser->getCurrentTokenType() == ParseTokenType::CloseDocument);
+      }
+    }
+  }
+}
+
+TEST_CASE("JSON-Parser with structural index", "[JSON]")
+{
+  GIVEN("The UTF-8 PullParser with structural index") {
+    WHEN("Skipping nested values") {
+      std::unique_ptr<sergut::json::PullParser> parser = sergut::json::PullParser::createIndexedParser(
+            sergut::misc::ConstStringRef("{ \"a\" : { \"b\": [1, \"]}\", {\"c\": {}}] } ,\n \"d\":  [ ],  \"e\": 3}"));
+      THEN("The parser is positioned on the end of the value") {
+        CHECK(parser->parseNext() == ParseTokenType::OpenObject);
+        CHECK(parser->parseNext() == ParseTokenType::MemberName);
+        CHECK(parser->parseNext() == ParseTokenType::OpenObject);
+        CHECK(parser->skipValue() == ParseTokenType::CloseObject);
+        CHECK(parser->getCurrentDepth() == 1);
+        CHECK(parser->parseNext() == ParseTokenType::MemberName);
+        CHECK(parser->getCurrentMemberName() == std::string("d"));
+        CHECK(parser->parseNext() == ParseTokenType::OpenArray);
+        CHECK(parser->skipValue() == ParseTokenType::CloseArray);
+        CHECK(parser->parseNext() == ParseTokenType::MemberName);
+        CHECK(parser->getCurrentMemberName() == std::string("e"));
+        CHECK(parser->parseNext() == ParseTokenType::Number);
+        CHECK(parser->skipValue() == ParseTokenType::Number);
+        CHECK(parser->parseNext() == ParseTokenType::CloseObject);
+        CHECK(parser->parseNext() == ParseTokenType::CloseDocument);
+      }
+    }
+    for(const std::string json: { "[1 2]", "[1}", "{\"a\":1,}", "[true x]", "[truex]", "[\"a\"\"b\"]", "{\"a\": [1, 2}",
+                                  "[[1, 2]", "[1]  x", "[  1 ,  , 2]" })
+    {
+      WHEN("Parsing the invalid document '" + json + "'") {
+        std::unique_ptr<sergut::json::PullParser> parser = sergut::json::PullParser::createIndexedParser(sergut::misc::ConstStringRef(json));
+        THEN("An error or an incomplete document is reported") {
+          CHECK_FALSE(parseAll(*parser).back().first == ParseTokenType::CloseDocument);
+        }
+      }
+    }
+    // the content of a skipped value is only checked for balanced brackets
+    for(const std::string json: { "[1, [2]}", "{\"a\": [1, 2]]", "[[1, 2]" }) {
+      WHEN("Skipping a value with a mismatching or missing closing bracket in '" + json + "'") {
+        std::unique_ptr<sergut::json::PullParser> parser = sergut::json::PullParser::createIndexedParser(sergut::misc::ConstStringRef(json));
+        THEN("An error or an incomplete document is reported") {
+          CHECK(parser->parseNext() != ParseTokenType::Error);
+          CHECK_FALSE(isOk(parser->skipValue()));
+        }
+      }
+    }
+    WHEN("Appending data to the parser") {
+      std::unique_ptr<sergut::json::PullParser> parser = sergut::json::PullParser::createIndexedParser(sergut::misc::ConstStringRef("[  [1], "));
+      CHECK(parser->parseNext() == ParseTokenType::OpenArray);
+      CHECK(parser->parseNext() == ParseTokenType::OpenArray);
+      CHECK(parser->skipValue() == ParseTokenType::CloseArray);
+      CHECK(parser->parseNext() == ParseTokenType::IncompleteDocument);
+      parser->appendData("  [2, [3]]]", 11);
+      THEN("The parser continues without index") {
+        CHECK(parser->parseNext() == ParseTokenType::OpenArray);
+        CHECK(parser->skipValue() == ParseTokenType::CloseArray);
+        CHECK(parser->parseNext() == ParseTokenType::CloseArray);
+        CHECK(parser->parseNext() == ParseTokenType::CloseDocument);
+      }
+    }
+  }
+}
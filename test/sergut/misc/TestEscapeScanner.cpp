@@ -0,0 +1,106 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "sergut/misc/EscapeScanner.h"
+
+#include <string>
+
+TEST_CASE("Find bytes that need escaping", "[EscapeScanner]")
+{
+  // lengths around the block sizes of the vectorized implementations
+  for(std::size_t size: {0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100}) {
+    const std::string clean(size, 'a');
+    GIVEN("A clean string of size " + std::to_string(size)) {
+      THEN("No special byte is found") {
+        CHECK(sergut::misc::EscapeScanner::findJsonSpecial(clean.data(), clean.data() + size) == clean.data() + size);
+        CHECK(sergut::misc::EscapeScanner::findXmlSpecial(clean.data(), clean.data() + size) == clean.data() + size);
+        CHECK(sergut::misc::EscapeScanner::findXmlTextSpecial(clean.data(), clean.data() + size, '"') == clean.data() + size);
+      }
+    }
+    for(std::size_t pos = 0; pos < size; ++pos) {
+      for(const char c: {'"', '\\', '\n', '\x01', '\x1f'}) {
+        std::string str = clean;
+        str[pos] = c;
+        const char* found = sergut::misc::EscapeScanner::findJsonSpecial(str.data(), str.data() + size);
+        if(found != str.data() + pos) {
+          FAIL("JSON: byte " + std::to_string(int(c)) + " at " + std::to_string(pos) + " of " + std::to_string(size) + " not found");
+        }
+      }
+      for(const char c: {'"', '&', '\'', '<', '>'}) {
+        std::string str = clean;
+        str[pos] = c;
+        const char* found = sergut::misc::EscapeScanner::findXmlSpecial(str.data(), str.data() + size);
+        if(found != str.data() + pos) {
+          FAIL("XML: byte " + std::to_string(int(c)) + " at " + std::to_string(pos) + " of " + std::to_string(size) + " not found");
+        }
+      }
+      for(const char c: {'<', '&', '\'', '\x01', '\x1f', '\x80', '\xff'}) {
+        std::string str = clean;
+        str[pos] = c;
+        const char* found = sergut::misc::EscapeScanner::findXmlTextSpecial(str.data(), str.data() + size, '\'');
+        if(found != str.data() + pos) {
+          FAIL("XML text: byte " + std::to_string(int(c)) + " at " + std::to_string(pos) + " of " + std::to_string(size) + " not found");
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Bytes that need no escaping are skipped", "[EscapeScanner]")
+{
+  std::string str;
+  for(int c = 0; c < 256; ++c) {
+    str.push_back(static_cast<char>(c));
+  }
+  GIVEN("All bytes in ascending order") {
+    std::string jsonSpecial;
+    std::string xmlSpecial;
+    for(const char* p = str.data(); p != str.data() + str.size(); ++p) {
+      p = sergut::misc::EscapeScanner::findJsonSpecial(p, str.data() + str.size());
+      if(p == str.data() + str.size()) {
+        break;
+      }
+      jsonSpecial.push_back(*p);
+    }
+    for(const char* p = str.data(); p != str.data() + str.size(); ++p) {
+      p = sergut::misc::EscapeScanner::findXmlSpecial(p, str.data() + str.size());
+      if(p == str.data() + str.size()) {
+        break;
+      }
+      xmlSpecial.push_back(*p);
+    }
+    std::string xmlTextSpecial;
+    for(const char* p = str.data(); p != str.data() + str.size(); ++p) {
+      p = sergut::misc::EscapeScanner::findXmlTextSpecial(p, str.data() + str.size(), '"');
+      if(p == str.data() + str.size()) {
+        break;
+      }
+      xmlTextSpecial.push_back(*p);
+    }
+    THEN("Exactly the special bytes are found") {
+      CHECK(jsonSpecial == str.substr(0, 0x20) + "\"\\");
+      CHECK(xmlSpecial == "\"&'<>");
+      CHECK(xmlTextSpecial == str.substr(0, 9) + str.substr(11, 2) + str.substr(14, 18) + "\"&<" + str.substr(0x80));
+    }
+  }
+}
@@ -0,0 +1,121 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "sergut/misc/NumberFormatter.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+template<typename DT>
+std::string format(const DT value)
+{
+  char buf[sergut::misc::NumberFormatter::maxLength];
+  return std::string(buf, sergut::misc::NumberFormatter::format(buf, value));
+}
+}
+
+TEST_CASE("Format integers", "[NumberFormatter]")
+{
+  CHECK(format(0) == "0");
+  CHECK(format(7) == "7");
+  CHECK(format(-7) == "-7");
+  CHECK(format(10) == "10");
+  CHECK(format(99) == "99");
+  CHECK(format(100) == "100");
+  CHECK(format(65000u) == "65000");
+  CHECK(format(std::numeric_limits<long long>::min()) == "-9223372036854775808");
+  CHECK(format(std::numeric_limits<long long>::max()) == "9223372036854775807");
+  CHECK(format(std::numeric_limits<unsigned long long>::max()) == "18446744073709551615");
+}
+
+TEST_CASE("Format floating point numbers", "[NumberFormatter]")
+{
+  const std::vector<std::pair<double, std::string>> doubles{
+    {0.0, "0"},
+    {-0.0, "-0"},
+    {1.0, "1"},
+    {2.25, "2.25"},
+    {-17.25, "-17.25"},
+    {3.14159, "3.14159"},
+    {0.1, "0.1"},
+    {0.1 + 0.2, "0.30000000000000004"},
+    {0.0001, "0.0001"},
+    {0.0000025, "2.5e-06"},
+    {1e16, "10000000000000000"},
+    {1e20, "1e+20"},
+    {1.7976931348623157e308, "1.7976931348623157e+308"},
+    {5e-324, "5e-324"},
+    {std::numeric_limits<double>::infinity(), "inf"},
+    {-std::numeric_limits<double>::infinity(), "-inf"},
+    {std::numeric_limits<double>::quiet_NaN(), "nan"},
+  };
+  for(const std::pair<double, std::string>& d: doubles) {
+    GIVEN("The double " + d.second) {
+      CHECK(format(d.first) == d.second);
+    }
+  }
+  const std::vector<std::pair<float, std::string>> floats{
+    {2.718f, "2.718"},
+    {0.1f, "0.1"},
+    {16777216.0f, "16777216"},
+    {3.4028235e38f, "3.4028235e+38"},
+    {1e-45f, "1e-45"},
+  };
+  for(const std::pair<float, std::string>& f: floats) {
+    GIVEN("The float " + f.second) {
+      CHECK(format(f.first) == f.second);
+    }
+  }
+}
+
+TEST_CASE("Formatted floating point numbers read back exactly", "[NumberFormatter]")
+{
+  std::mt19937_64 rng(42);
+  for(int i = 0; i < 100000; ++i) {
+    const std::uint64_t bits = rng();
+    double d;
+    std::memcpy(&d, &bits, sizeof(d));
+    if(std::isfinite(d)) {
+      const std::string str = format(d);
+      if(std::strtod(str.c_str(), nullptr) != d) {
+        FAIL("Double " + str + " does not read back");
+      }
+    }
+    const std::uint32_t fbits = static_cast<std::uint32_t>(bits);
+    float f;
+    std::memcpy(&f, &fbits, sizeof(f));
+    if(std::isfinite(f)) {
+      const std::string str = format(f);
+      if(std::strtof(str.c_str(), nullptr) != f) {
+        FAIL("Float " + str + " does not read back");
+      }
+    }
+  }
+}
@@ -0,0 +1,65 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "sergut/misc/ThreadPool.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("Run tasks on a thread pool", "[ThreadPool]")
+{
+  for(std::size_t threadCount: {0, 1, 3}) {
+    GIVEN("A thread pool with " + std::to_string(threadCount) + " threads") {
+      sergut::misc::ThreadPool pool(threadCount);
+      WHEN("Running a parallel for loop") {
+        std::vector<int> calls(1000, 0);
+        pool.parallelFor(calls.size(), [&](const std::size_t i) { ++calls[i]; });
+
+        THEN("The task is called exactly once per index") {
+          CHECK(calls == std::vector<int>(1000, 1));
+        }
+      }
+      WHEN("Running a parallel for loop without indices") {
+        std::atomic<int> calls(0);
+        pool.parallelFor(0, [&](const std::size_t) { ++calls; });
+
+        THEN("The task is not called") {
+          CHECK(calls == 0);
+        }
+      }
+      WHEN("A task throws") {
+        THEN("The exception is rethrown and the pool remains usable") {
+          CHECK_THROWS_AS(pool.parallelFor(100, [](const std::size_t i) {
+                            if(i == 50) {
+                              throw std::runtime_error("task failed");
+                            }
+                          }), std::runtime_error);
+          std::atomic<int> calls(0);
+          pool.parallelFor(100, [&](const std::size_t) { ++calls; });
+          CHECK(calls == 100);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,110 @@
+/* Copyright (c) 2016 Tobias Koelsch
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "sergut/xml/detail/Helper.h"
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+TEST_CASE("XML name character classification", "[XML]")
+{
+  // characters at the borders of the ranges of [4] NameStartChar and [4a] NameChar
+  const std::vector<std::tuple<sergut::unicode::Utf32Char, bool, bool>>
+      chars{
+        std::make_tuple(0x00,    false, false),
+        std::make_tuple('-',     false, true ),
+        std::make_tuple('.',     false, true ),
+        std::make_tuple('/',     false, false),
+        std::make_tuple('0',     false, true ),
+        std::make_tuple('9',     false, true ),
+        std::make_tuple(':',     true,  true ),
+        std::make_tuple(';',     false, false),
+        std::make_tuple('@',     false, false),
+        std::make_tuple('A',     true,  true ),
+        std::make_tuple('Z',     true,  true ),
+        std::make_tuple('[',     false, false),
+        std::make_tuple('_',     true,  true ),
+        std::make_tuple('`',     false, false),
+        std::make_tuple('a',     true,  true ),
+        std::make_tuple('z',     true,  true ),
+        std::make_tuple('{',     false, false),
+        std::make_tuple(0x7F,    false, false),
+        std::make_tuple(0xB6,    false, false),
+        std::make_tuple(0xB7,    false, true ),
+        std::make_tuple(0xBF,    false, false),
+        std::make_tuple(0xC0,    true,  true ),
+        std::make_tuple(0xD7,    false, false),
+        std::make_tuple(0xF7,    false, false),
+        std::make_tuple(0x2FF,   true,  true ),
+        std::make_tuple(0x300,   false, true ),
+        std::make_tuple(0x36F,   false, true ),
+        std::make_tuple(0x370,   true,  true ),
+        std::make_tuple(0x37E,   false, false),
+        std::make_tuple(0x1FFF,  true,  true ),
+        std::make_tuple(0x2000,  false, false),
+        std::make_tuple(0x200C,  true,  true ),
+        std::make_tuple(0x200E,  false, false),
+        std::make_tuple(0x203E,  false, false),
+        std::make_tuple(0x203F,  false, true ),
+        std::make_tuple(0x2040,  false, true ),
+        std::make_tuple(0x2041,  false, false),
+        std::make_tuple(0x206F,  false, false),
+        std::make_tuple(0x2070,  true,  true ),
+        std::make_tuple(0x218F,  true,  true ),
+        std::make_tuple(0x2190,  false, false),
+        std::make_tuple(0x2C00,  true,  true ),
+        std::make_tuple(0x2FEF,  true,  true ),
+        std::make_tuple(0x2FF0,  false, false),
+        std::make_tuple(0x3000,  false, false),
+        std::make_tuple(0x3001,  true,  true ),
+        std::make_tuple(0xD7FF,  true,  true ),
+        std::make_tuple(0xD800,  false, false),
+        std::make_tuple(0xF8FF,  false, false),
+        std::make_tuple(0xF900,  true,  true ),
+        std::make_tuple(0xFDCF,  true,  true ),
+        std::make_tuple(0xFDD0,  false, false),
+        std::make_tuple(0xFDF0,  true,  true ),
+        std::make_tuple(0xFFFD,  true,  true ),
+        std::make_tuple(0xFFFE,  false, false),
+        std::make_tuple(0x10000, true,  true ),
+        std::make_tuple(0xEFFFF, true,  true ),
+        std::make_tuple(0xF0000, false, false),
+      };
+  for(const std::tuple<sergut::unicode::Utf32Char, bool, bool>& chr: chars) {
+    GIVEN("The character " + std::to_string(std::get<0>(chr))) {
+      THEN("It is classified correctly") {
+        CHECK(sergut::xml::detail::Helper::isNameStartChar(std::get<0>(chr)) == std::get<1>(chr));
+        CHECK(sergut::xml::detail::Helper::isNameChar(std::get<0>(chr)) == std::get<2>(chr));
+        if(std::get<0>(chr) < 0x80) {
+          CHECK(sergut::xml::detail::Helper::isAsciiNameChar(static_cast<char>(std::get<0>(chr))) == std::get<2>(chr));
+        }
+      }
+    }
+  }
+  GIVEN("A non-ASCII byte") {
+    THEN("It is no ASCII name character") {
+      CHECK(!sergut::xml::detail::Helper::isAsciiNameChar('\xc3'));
+    }
+  }
+}
@@ -21,12 +21,17 @@
 
 #include <catch2/catch.hpp>
 
+#include "sergut/Exception.h"
 #include "sergut/xml/PullParser.h"
 #include "sergut/xml/detail/PullParserUtf16LE.h"
 #include "sergut/xml/detail/PullParserUtf16BE.h"
 
+#include <algorithm>
 #include <set>
 
+#include <stdlib.h>
+#include <unistd.h>
+
 enum class TargetEncoding { Utf8, Utf16BE, Utf16LE };
 std::string toString(const TargetEncoding encoding, const bool shortDesc = false)
 {
@@ -783,3 +788,398 @@ TEST_CASE("XML-Parser (savepoint Test)", "[XML]")
     }
   }
 }
+
+TEST_CASE("XML-Parser UTF-8 (Names with non-ASCII characters)", "[XML]")
+{
+  GIVEN("Tag and attribute names that mix ASCII and non-ASCII characters") {
+    const std::string xml = "<r\xc3\xb6\xc3\xb6t-1   \n\t a\xc3\xa4ttr.b:c \t = \"x\"\n>"
+                            "<\xc3\xa4\xc3\xb6\xc3\xbc\xc2\xb7x/>     </r\xc3\xb6\xc3\xb6t-1  >";
+    WHEN("Parsing the complete document") {
+      std::unique_ptr<sergut::xml::PullParser> parser = sergut::xml::PullParser::createParser(sergut::misc::ConstStringRef(xml));
+      THEN("The names are decoded") {
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::OpenDocument);
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::OpenTag);
+        CHECK(parser->getCurrentTagName() == std::string("r\xc3\xb6\xc3\xb6t-1"));
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::Attribute);
+        CHECK(parser->getCurrentAttributeName() == std::string("a\xc3\xa4ttr.b:c"));
+        CHECK(parser->getCurrentValue() == std::string("x"));
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::OpenTag);
+        CHECK(parser->getCurrentTagName() == std::string("\xc3\xa4\xc3\xb6\xc3\xbc\xc2\xb7x"));
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::CloseTag);
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::Text);
+        CHECK(parser->getCurrentValue() == std::string("     "));
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::CloseTag);
+        CHECK(parser->getCurrentTagName() == std::string("r\xc3\xb6\xc3\xb6t-1"));
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::CloseDocument);
+      }
+    }
+    for(std::size_t cut = 1; cut < 40; ++cut) {
+      WHEN("The document is cut off after " + std::to_string(cut) + " bytes") {
+        std::unique_ptr<sergut::xml::PullParser> parser =
+            sergut::xml::PullParser::createParser(sergut::misc::ConstStringRef(xml.data(), xml.data() + cut));
+        THEN("It is incomplete and not an error") {
+          while(parser->parseNext() != sergut::xml::ParseTokenType::IncompleteDocument) {
+            REQUIRE(parser->isOk());
+          }
+        }
+      }
+    }
+  }
+  GIVEN("A name that contains an invalid character") {
+    const std::string xml = "<root\xc3\x97x/>";
+    WHEN("Parsing the document") {
+      std::unique_ptr<sergut::xml::PullParser> parser = sergut::xml::PullParser::createParser(sergut::misc::ConstStringRef(xml));
+      THEN("The name ends in front of it and an error occurs") {
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::OpenDocument);
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::OpenTag);
+        CHECK(parser->getCurrentTagName() == std::string("root"));
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::Error);
+      }
+    }
+  }
+}
+
+TEST_CASE("XML-Parser UTF-8 (Values with and without references)", "[XML]")
+{
+  GIVEN("Attribute values and texts with and without references") {
+    const std::string xml = "<root a=\"plain\" b=\"x&amp;y\">text 1<i c='42'/>more &lt;text&gt;</root>";
+    WHEN("Parsing the document") {
+      std::unique_ptr<sergut::xml::PullParser> parser = sergut::xml::PullParser::createParser(sergut::misc::ConstStringRef(xml));
+      THEN("The values are decoded where needed") {
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::OpenDocument);
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::OpenTag);
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::Attribute);
+        CHECK(parser->getCurrentValue() == std::string("plain"));
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::Attribute);
+        CHECK(parser->getCurrentValue() == std::string("x&y"));
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::Text);
+        CHECK(parser->getCurrentValue() == std::string("text 1"));
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::OpenTag);
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::Attribute);
+        CHECK(parser->getCurrentValue() == std::string("42"));
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::CloseTag);
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::Text);
+        CHECK(parser->getCurrentValue() == std::string("more <text>"));
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::CloseTag);
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::CloseDocument);
+      }
+    }
+  }
+  for(const bool withSavePoint: {false, true}) {
+    GIVEN("A document that is appended while on a value (setting save points " + std::to_string(withSavePoint) + ")") {
+      const std::string element = "<e a=\"value\">text</e>";
+      const std::string initialXml = "<root>" + element;
+      std::unique_ptr<sergut::xml::PullParser> parser = sergut::xml::PullParser::createParser(sergut::misc::ConstStringRef(initialXml));
+      CHECK(parser->parseNext() == sergut::xml::ParseTokenType::OpenDocument);
+      CHECK(parser->parseNext() == sergut::xml::ParseTokenType::OpenTag);
+      WHEN("Appending data after each value") {
+        THEN("The values stay valid") {
+          for(int i = 0; i < 5; ++i) {
+            REQUIRE(parser->parseNext() == sergut::xml::ParseTokenType::OpenTag);
+            if(withSavePoint) { parser->setSavePointAtCurrentTag(); }
+            REQUIRE(parser->parseNext() == sergut::xml::ParseTokenType::Attribute);
+            parser->appendData(element.data(), element.size());
+            CHECK(parser->getCurrentValue() == std::string("value"));
+            REQUIRE(parser->parseNext() == sergut::xml::ParseTokenType::Text);
+            parser->appendData("", 0);
+            CHECK(parser->getCurrentValue() == std::string("text"));
+            REQUIRE(parser->parseNext() == sergut::xml::ParseTokenType::CloseTag);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("XML-Parser (borrowed data)", "[XML]")
+{
+  for(const TargetEncoding encodingType: encodings)
+  {
+    GIVEN("The " + toString(encodingType) + " PullParser borrowing the data") {
+      const std::string xml = asciiToEncoding("<root attr=\"value\">text<inner/></root>", encodingType);
+      std::unique_ptr<sergut::xml::PullParser> parser =
+          sergut::xml::PullParser::createParser(sergut::misc::ConstStringRef(xml), sergut::xml::PullParser::DataOwnership::Borrow);
+      WHEN("Parsing the document") {
+        THEN("The result is the same as with copied data") {
+          CHECK(parser->parseNext() == sergut::xml::ParseTokenType::OpenDocument);
+          CHECK(parser->parseNext() == sergut::xml::ParseTokenType::OpenTag);
+          CHECK(parser->getCurrentTagName() == std::string("root"));
+          CHECK(parser->parseNext() == sergut::xml::ParseTokenType::Attribute);
+          CHECK(parser->getCurrentAttributeName() == std::string("attr"));
+          CHECK(parser->getCurrentValue() == std::string("value"));
+          if(encodingType == TargetEncoding::Utf8) {
+            // the value is not copied at all
+            CHECK(parser->getCurrentValue().begin() == xml.data() + xml.find("value"));
+          }
+          CHECK(parser->parseNext() == sergut::xml::ParseTokenType::Text);
+          CHECK(parser->getCurrentValue() == std::string("text"));
+          CHECK(parser->parseNext() == sergut::xml::ParseTokenType::OpenTag);
+          CHECK(parser->parseNext() == sergut::xml::ParseTokenType::CloseTag);
+          CHECK(parser->parseNext() == sergut::xml::ParseTokenType::CloseTag);
+          CHECK(parser->getCurrentTagName() == std::string("root"));
+          CHECK(parser->parseNext() == sergut::xml::ParseTokenType::CloseDocument);
+        }
+      }
+    }
+    GIVEN("The " + toString(encodingType) + " PullParser borrowing incomplete data") {
+      std::string xml = asciiToEncoding("<root attr=\"value\"><inner>te", encodingType);
+      std::unique_ptr<sergut::xml::PullParser> parser =
+          sergut::xml::PullParser::createParser(sergut::misc::ConstStringRef(xml), sergut::xml::PullParser::DataOwnership::Borrow);
+      WHEN("Appending the rest of the document") {
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::OpenDocument);
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::OpenTag);
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::Attribute);
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::OpenTag);
+        CHECK(parser->setSavePointAtCurrentTag());
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::IncompleteDocument);
+        const std::string rest = asciiToEncoding("xt</inner></root>", encodingType, false);
+        parser->appendData(rest.data(), rest.size());
+        // the parser does not need the borrowed data anymore
+        std::fill(xml.begin(), xml.end(), '\0');
+        THEN("The parser continues on its own copy of the data") {
+          CHECK(parser->restoreToSavePoint());
+          CHECK(parser->getCurrentTokenType() == sergut::xml::ParseTokenType::OpenTag);
+          CHECK(parser->getCurrentTagName() == std::string("inner"));
+          CHECK(parser->parseNext() == sergut::xml::ParseTokenType::Text);
+          CHECK(parser->getCurrentValue() == std::string("text"));
+          CHECK(parser->parseNext() == sergut::xml::ParseTokenType::CloseTag);
+          CHECK(parser->parseNext() == sergut::xml::ParseTokenType::CloseTag);
+          CHECK(parser->getCurrentTagName() == std::string("root"));
+          CHECK(parser->parseNext() == sergut::xml::ParseTokenType::CloseDocument);
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("XML-Parser (from file)", "[XML]")
+{
+  for(const TargetEncoding encodingType: encodings)
+  {
+    GIVEN("A " + toString(encodingType) + " file") {
+      char path[] = "/tmp/sergutTestPullParserXXXXXX";
+      const int fd = ::mkstemp(path);
+      REQUIRE(fd >= 0);
+      const std::string xml = asciiToEncoding("<root attr=\"value\">text</root>", encodingType);
+      REQUIRE(::write(fd, xml.data(), xml.size()) == static_cast<ssize_t>(xml.size()));
+      ::close(fd);
+      WHEN("Parsing the file") {
+        std::unique_ptr<sergut::xml::PullParser> parser = sergut::xml::PullParser::createParserFromFile(path);
+        ::unlink(path);
+        THEN("The result is the same as with data in memory") {
+          CHECK(parser->parseNext() == sergut::xml::ParseTokenType::OpenDocument);
+          CHECK(parser->parseNext() == sergut::xml::ParseTokenType::OpenTag);
+          CHECK(parser->getCurrentTagName() == std::string("root"));
+          CHECK(parser->parseNext() == sergut::xml::ParseTokenType::Attribute);
+          CHECK(parser->getCurrentValue() == std::string("value"));
+          CHECK(parser->parseNext() == sergut::xml::ParseTokenType::Text);
+          CHECK(parser->getCurrentValue() == std::string("text"));
+          CHECK(parser->parseNext() == sergut::xml::ParseTokenType::CloseTag);
+          CHECK(parser->parseNext() == sergut::xml::ParseTokenType::CloseDocument);
+        }
+      }
+    }
+  }
+  GIVEN("A path that does not exist") {
+    THEN("Creating the parser throws") {
+      CHECK_THROWS_AS(sergut::xml::PullParser::createParserFromFile("/nonexistent/sergut.xml"), sergut::Exception);
+    }
+  }
+}
+
+namespace {
+/// Returns the data in pieces of at most maxReadSize bytes
+class ChunkedInputSource: public sergut::misc::InputSource
+{
+public:
+  ChunkedInputSource(const std::string& pData, const std::size_t pMaxReadSize)
+    : data(pData), maxReadSize(pMaxReadSize)
+  { }
+
+  std::size_t read(char* buffer, const std::size_t size) override {
+    const std::size_t readSize = std::min(std::min(size, maxReadSize), data.size() - readPos);
+    std::copy(data.begin() + readPos, data.begin() + readPos + readSize, buffer);
+    readPos += readSize;
+    ++readCount;
+    return readSize;
+  }
+
+public:
+  std::size_t readCount = 0;
+
+private:
+  const std::string data;
+  const std::size_t maxReadSize;
+  std::size_t readPos = 0;
+};
+
+std::string toString(const sergut::xml::ParseTokenType tokenType)
+{
+  return std::to_string(static_cast<uint32_t>(tokenType));
+}
+
+std::vector<std::string> collectTokens(sergut::xml::PullParser& parser)
+{
+  std::vector<std::string> tokens;
+  while(true) {
+    const sergut::xml::ParseTokenType tokenType = parser.parseNext();
+    std::string token = toString(tokenType);
+    switch(tokenType) {
+    case sergut::xml::ParseTokenType::OpenTag:
+    case sergut::xml::ParseTokenType::CloseTag:
+      token += " " + parser.getCurrentTagName().toString();
+      break;
+    case sergut::xml::ParseTokenType::Attribute:
+      token += " " + parser.getCurrentAttributeName().toString() + "=" + parser.getCurrentValue().toString();
+      break;
+    case sergut::xml::ParseTokenType::Text:
+      token += " " + parser.getCurrentValue().toString();
+      break;
+    default:
+      break;
+    }
+    tokens.push_back(token);
+    if(!parser.isOk() || tokenType == sergut::xml::ParseTokenType::CloseDocument) {
+      return tokens;
+    }
+  }
+}
+}
+
+TEST_CASE("XML-Parser (input source)", "[XML]")
+{
+  const std::string xml =
+      "<?xml version=\"1.0\"?>\n"
+      "<root a=\"1\" b='x&amp;y'>\n"
+      "  <child name=\"first\">some text &lt;here&gt;</child>\n"
+      "  <child name=\"second\"/>\n"
+      "  <nested><inner deep=\"yes\">&#65;&#x42;C</inner></nested>\n"
+      "</root>";
+  for(const TargetEncoding encodingType: encodings)
+  {
+    const std::string encodedXml = asciiToEncoding(xml, encodingType);
+    std::unique_ptr<sergut::xml::PullParser> referenceParser = sergut::xml::PullParser::createParser(sergut::misc::ConstStringRef(encodedXml));
+    const std::vector<std::string> referenceTokens = collectTokens(*referenceParser);
+    REQUIRE(referenceTokens.back() == toString(sergut::xml::ParseTokenType::CloseDocument));
+    for(const std::size_t chunkSize: {std::size_t(1), std::size_t(3), std::size_t(16), std::size_t(4096)}) {
+      GIVEN("A " + toString(encodingType) + " document that is read in chunks of " + std::to_string(chunkSize) + " bytes") {
+        ChunkedInputSource source(encodedXml, chunkSize);
+        std::unique_ptr<sergut::xml::PullParser> parser = sergut::xml::PullParser::createParser(source, chunkSize);
+        WHEN("Parsing the document") {
+          THEN("The tokens are the same as when parsing the complete document") {
+            CHECK(collectTokens(*parser) == referenceTokens);
+          }
+        }
+      }
+    }
+    GIVEN("A " + toString(encodingType) + " document that is read in small chunks with save points") {
+      ChunkedInputSource source(encodedXml, 2);
+      std::unique_ptr<sergut::xml::PullParser> parser = sergut::xml::PullParser::createParser(source, 2);
+      WHEN("Restoring the save point after parsing further") {
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::OpenDocument);
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::OpenTag);
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::Attribute);
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::Attribute);
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::Text);
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::OpenTag);
+        CHECK(parser->getCurrentTagName() == std::string("child"));
+        CHECK(parser->setSavePointAtCurrentTag());
+        for(int i = 0; i < 8; ++i) {
+          CHECK(parser->isOk());
+          parser->parseNext();
+        }
+        CHECK(parser->restoreToSavePoint());
+        THEN("The parser continues from the save point") {
+          CHECK(parser->getCurrentTokenType() == sergut::xml::ParseTokenType::OpenTag);
+          CHECK(parser->getCurrentTagName() == std::string("child"));
+          std::vector<std::string> tokens = collectTokens(*parser);
+          const std::vector<std::string> expectedTokens(referenceTokens.begin() + 6, referenceTokens.end());
+          CHECK(tokens == expectedTokens);
+        }
+      }
+    }
+    GIVEN("A " + toString(encodingType) + " document that is read with a chunk size of 0") {
+      ChunkedInputSource source(encodedXml, 7);
+      std::unique_ptr<sergut::xml::PullParser> parser = sergut::xml::PullParser::createParser(source, 0);
+      WHEN("Parsing the document") {
+        THEN("The data is read in chunks of at least one byte") {
+          CHECK(collectTokens(*parser) == referenceTokens);
+        }
+      }
+    }
+    GIVEN("A truncated " + toString(encodingType) + " document") {
+      ChunkedInputSource source(encodedXml.substr(0, encodedXml.size() / 2), 5);
+      std::unique_ptr<sergut::xml::PullParser> parser = sergut::xml::PullParser::createParser(source, 5);
+      WHEN("Parsing the document") {
+        THEN("The parser reports an incomplete document at the end of the input") {
+          const std::vector<std::string> tokens = collectTokens(*parser);
+          CHECK(tokens.back() == toString(sergut::xml::ParseTokenType::IncompleteDocument));
+          CHECK(tokens.size() < referenceTokens.size());
+          CHECK(parser->parseNext() == sergut::xml::ParseTokenType::IncompleteDocument);
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("XML-Parser (empty input source)", "[XML]")
+{
+  GIVEN("An input source without any data") {
+    ChunkedInputSource source("", 4);
+    std::unique_ptr<sergut::xml::PullParser> parser = sergut::xml::PullParser::createParser(source);
+    WHEN("Parsing the document") {
+      THEN("The document is incomplete") {
+        CHECK(parser->parseNext() == sergut::xml::ParseTokenType::IncompleteDocument);
+      }
+    }
+  }
+}
+
+TEST_CASE("XML-Parser (continue after appending data)", "[XML]")
+{
+  const std::string xml =
+      "<?xml version=\"1.0\"?>\n"
+      "<root a=\"1\" b='x&amp;y'>\n"
+      "  <child name=\"first\">some text &lt;here&gt;</child>\n"
+      "  <child name=\"second\"/>\n"
+      "  <nested><inner deep=\"yes\">&#65;&#x42;C</inner></nested>\n"
+      "</root>";
+  for(const TargetEncoding encodingType: encodings)
+  {
+    const std::string encodedXml = asciiToEncoding(xml, encodingType);
+    std::unique_ptr<sergut::xml::PullParser> referenceParser = sergut::xml::PullParser::createParser(sergut::misc::ConstStringRef(encodedXml));
+    const std::vector<std::string> referenceTokens = collectTokens(*referenceParser);
+    REQUIRE(referenceTokens.back() == toString(sergut::xml::ParseTokenType::CloseDocument));
+    for(const std::size_t initialSize: {std::size_t(0), std::size_t(4)}) {
+      if(initialSize == 0 && encodingType != TargetEncoding::Utf8) {
+        // without data the encoding cannot be detected
+        continue;
+      }
+      for(const std::size_t chunkSize: {std::size_t(1), std::size_t(3), std::size_t(16)}) {
+        GIVEN("A " + toString(encodingType) + " document of which " + std::to_string(initialSize)
+              + " bytes are available and the rest is appended in chunks of " + std::to_string(chunkSize) + " bytes") {
+          std::unique_ptr<sergut::xml::PullParser> parser =
+              sergut::xml::PullParser::createParser(sergut::misc::ConstStringRef(encodedXml.data(), encodedXml.data() + initialSize));
+          std::size_t pos = initialSize;
+          WHEN("Appending data whenever the parser reports an incomplete document") {
+            std::vector<std::string> tokens;
+            while(true) {
+              const std::vector<std::string> newTokens = collectTokens(*parser);
+              tokens.insert(tokens.end(), newTokens.begin(), newTokens.end() - 1);
+              if(newTokens.back() != toString(sergut::xml::ParseTokenType::IncompleteDocument) || pos == encodedXml.size()) {
+                tokens.push_back(newTokens.back());
+                break;
+              }
+              const std::size_t size = std::min(chunkSize, encodedXml.size() - pos);
+              parser->appendData(encodedXml.data() + pos, size);
+              pos += size;
+            }
+            THEN("The tokens are the same as when parsing the complete document") {
+              CHECK(tokens == referenceTokens);
+            }
+          }
+        }
+      }
+    }
+  }
+}
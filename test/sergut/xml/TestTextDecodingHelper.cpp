@@ -280,3 +280,83 @@ TEST_CASE("XML-Parser UTF-8 (Legal character Handling)", "[XML]")
     }
   }
 }
+
+TEST_CASE("XML-Parser UTF-8 (Long texts)", "[XML]")
+{
+  // long enough that the plain runs are copied in blocks
+  const std::string plain = "The quick brown fox jumps over the lazy dog.\n\tThe quick brown fox jumps over the lazy dog.";
+  const std::vector<std::pair<std::string, std::string>>
+      specials{
+        {"",              ""            },
+        {"&amp;",         "&"           },
+        {"\xc3\xa4",      "\xc3\xa4"    },
+        {"&#x1F600;",     "\xf0\x9f\x98\x80"},
+        {"\r\n",          "\r\n"        },
+      };
+  for(const std::pair<std::string, std::string>& special: specials) {
+    for(const std::size_t pos: {std::size_t(0), std::size_t(15), std::size_t(33), plain.size()}) {
+      GIVEN("A long text with '" + special.first + "' at position " + std::to_string(pos)) {
+        const std::string in = plain.substr(0, pos) + special.first + plain.substr(pos) + "<";
+        const std::string expected = plain.substr(0, pos) + special.second + plain.substr(pos);
+        WHEN("Parsing it as CharData") {
+          std::vector<char> out;
+          Utf8DecodingHelper helper(out, Utf8DecodingHelper::TextType::CharData, &*in.begin(), &*in.end());
+          THEN("The result is the decoded text") {
+            CHECK(helper.decodeText());
+            CHECK(std::string(out.begin(), out.end()) == expected);
+            CHECK(helper.getEndOfTextPointer() == &in.back());
+          }
+        }
+      }
+    }
+  }
+  GIVEN("A long text with an illegal control character") {
+    const std::string in = plain + '\x01' + plain + "<";
+    THEN("A parsing error occurs") {
+      std::vector<char> out;
+      Utf8DecodingHelper helper(out, Utf8DecodingHelper::TextType::CharData, &*in.begin(), &*in.end());
+      CHECK(!helper.decodeText());
+      CHECK(helper.isError());
+    }
+  }
+  GIVEN("A long text that is cut off") {
+    THEN("The text is incomplete") {
+      std::vector<char> out;
+      Utf8DecodingHelper helper(out, Utf8DecodingHelper::TextType::AttValueQuote, &*plain.begin(), &*plain.end());
+      CHECK(!helper.decodeText());
+      CHECK(helper.isIncomplete());
+    }
+  }
+}
+
+TEST_CASE("XML-Parser UTF-8 (Verbatim text)", "[XML]")
+{
+  const std::vector<std::tuple<std::string, std::string, bool>>
+      texts{
+        std::make_tuple("",                                    "",                       true ),
+        std::make_tuple("plain",                               "plain",                  true ),
+        std::make_tuple("\xc3\xa4 and a long text of 32 bytes", "\xc3\xa4 and a long text of 32 bytes", true ),
+        std::make_tuple("&amp;",                               "&",                      false),
+        std::make_tuple("a long text of 32 bytes and &lt;!", "a long text of 32 bytes and <!", false),
+      };
+  for(const std::tuple<std::string, std::string, bool>& text: texts) {
+    GIVEN("The text '" + std::get<0>(text) + "'") {
+      WHEN("Decoding it, allowing verbatim text") {
+        const std::string in = std::get<0>(text) + "\"";
+        std::vector<char> out;
+        Utf8DecodingHelper helper(out, Utf8DecodingHelper::TextType::AttValueQuote, &*in.begin(), &*in.end());
+        helper.allowVerbatimText();
+        THEN("It is only copied if it contains references") {
+          CHECK(helper.decodeText());
+          CHECK(helper.isVerbatimText() == std::get<2>(text));
+          if(helper.isVerbatimText()) {
+            CHECK(out.empty());
+            CHECK(std::string(helper.getStartOfTextPointer(), helper.getEndOfTextPointer()) == std::get<1>(text));
+          } else {
+            CHECK(std::string(out.begin(), out.end()) == std::get<1>(text));
+          }
+        }
+      }
+    }
+  }
+}
@@ -10,6 +10,8 @@ TARGET = test
 CONFIG += console
 CONFIG -= app_bundle
 CONFIG += c++11
+CONFIG += thread
+CONFIG += object_parallel_to_source
 
 LIBS += -L "$${OUT_PWD}/../lib" -L "$${CPP_TINYXML_LIB_PATH}" -lsergut -ltinyxml2 -ltinyxml
 
@@ -24,14 +26,22 @@ SOURCES += \
     main.cpp \
     sergut/TestJavaClassGenerator.cpp \
     sergut/TestXsdGenerator.cpp \
+    sergut/json/TestPullParser.cpp \
+    sergut/json/TestStructuralIndex.cpp \
     sergut/marshaller/TestRequestClient.cpp \
     sergut/marshaller/TestRequestServer.cpp \
     sergut/marshaller/TestRequestSpecificationGenerator.cpp \
+    sergut/misc/TestEscapeScanner.cpp \
+    sergut/misc/TestNumberFormatter.cpp \
+    sergut/misc/TestThreadPool.cpp \
     sergut/unicode/TestUtf16Codec.cpp \
     sergut/unicode/TestUtf8Codec.cpp \
+    sergut/xml/TestHelper.cpp \
     sergut/xml/TestPullParser.cpp \
     sergut/xml/TestTextDecodingHelper.cpp \
     sergut/TestSergutJson.cpp \
+    sergut/TestSergutJsonPull.cpp \
+    sergut/TestSergutNdJson.cpp \
     sergut/TestSergutUrl.cpp \
     sergut/TestSergutXml.cpp
 